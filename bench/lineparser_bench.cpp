@@ -0,0 +1,139 @@
+#include "lineparser.h"
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <functional>
+#include <limits>
+#include <QTextStream>
+
+// Сравнение пропускной способности старого построчного чтения и потокового LineReader
+namespace {
+
+struct Result {
+    qint64 lines = 0;
+    qint64 checksum = 0;
+};
+
+Result readLegacy(const QString& filePath)
+{
+    Result result;
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        return result;
+    }
+    while (!file.atEnd()) {
+        QString line = QString::fromUtf8(file.readLine()).trimmed();
+        if (!line.isEmpty()) {
+            ++result.lines;
+            result.checksum += line.size();
+        }
+    }
+    return result;
+}
+
+Result readLineReader(const QString& filePath, bool decode)
+{
+    Result result;
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return result;
+    }
+    LineReader reader(&file);
+    QByteArrayView line;
+    while (reader.next(line)) {
+        ++result.lines;
+        result.checksum += decode ? QString::fromUtf8(line).size() : line.size();
+    }
+    return result;
+}
+
+bool generate(const QString& filePath, qint64 megabytes)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+
+    const QByteArray latin = "Which keyword declares a constant expression evaluated at compile time";
+    const QByteArray cyrillic = QString("Какой оператор освобождает память, выделенную через new").toUtf8();
+    const qint64 target = megabytes * 1024 * 1024;
+    QByteArray block;
+    for (int i = 1; block.size() < (1 << 20); ++i) {
+        block += QByteArray::number(i) + ". " + ((i % 3) ? cyrillic : latin);
+        if (i % 4 == 1) {
+            block += " {ans}";
+        }
+        block += (i % 5 == 0) ? "\n\n" : "\n";
+    }
+    for (qint64 written = 0; written < target; written += block.size()) {
+        if (file.write(block) != block.size()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("quizown-parse-bench");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Measures question file parsing throughput in MB/s");
+    parser.addHelpOption();
+    parser.addPositionalArgument("file", "Questions or answers file to parse");
+    QCommandLineOption generateOption("generate", "Write a synthetic file of <megabytes> MB first", "megabytes");
+    QCommandLineOption repeatOption("repeat", "Number of passes per method", "count", "3");
+    parser.addOption(generateOption);
+    parser.addOption(repeatOption);
+    parser.process(app);
+
+    const QStringList args = parser.positionalArguments();
+    if (args.size() != 1) {
+        parser.showHelp(1);
+    }
+    const QString filePath = args.first();
+
+    QTextStream out(stdout);
+    if (parser.isSet(generateOption)) {
+        if (!generate(filePath, parser.value(generateOption).toLongLong())) {
+            QTextStream(stderr) << "Failed to generate " << filePath << Qt::endl;
+            return 1;
+        }
+    }
+
+    const qint64 bytes = QFileInfo(filePath).size();
+    const int repeat = qMax(1, parser.value(repeatOption).toInt());
+
+    struct Method {
+        const char* name;
+        std::function<Result()> run;
+    };
+    const Method methods[] = {
+        { "legacy_readline", [&]() { return readLegacy(filePath); } },
+        { "linereader_decode", [&]() { return readLineReader(filePath, true); } },
+        { "linereader_scan", [&]() { return readLineReader(filePath, false); } },
+    };
+
+    out << "# kernel: " << LineScanner::implementation() << ", file: " << filePath
+        << ", bytes: " << bytes << Qt::endl;
+    out << "method,lines,seconds,mb_per_s" << Qt::endl;
+    for (const Method& method : methods) {
+        qint64 bestNs = std::numeric_limits<qint64>::max();
+        Result result;
+        for (int i = 0; i < repeat; ++i) {
+            QElapsedTimer timer;
+            timer.start();
+            result = method.run();
+            bestNs = qMin(bestNs, timer.nsecsElapsed());
+        }
+        const double seconds = double(bestNs) / 1e9;
+        out << method.name << ',' << result.lines << ',' << seconds << ','
+            << (seconds > 0 ? double(bytes) / (1024.0 * 1024.0) / seconds : 0.0) << Qt::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,514 @@
+#include "metrics.h"
+#include "questionbank.h"
+#include "sessionpool.h"
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRandomGenerator>
+#include <QTcpSocket>
+#include <QTextStream>
+#include <QThread>
+#include <array>
+#include <functional>
+#include <memory>
+#include <queue>
+#include <vector>
+
+// Нагрузочный тест: N виртуальных кандидатов проходят тесты одновременно,
+// задержка каждой операции собирается в гистограмму
+namespace {
+
+enum Operation {
+    StartSectionTest,
+    CheckAnswer,
+    NextQuestion,
+    OperationCount
+};
+
+const char* const kOperationNames[OperationCount] = { "startSectionTest", "checkAnswer", "nextQuestion" };
+
+// Движок, против которого работает кандидат: сессия в процессе либо сервер --serve по HTTP
+class Client
+{
+public:
+    virtual ~Client() = default;
+
+    // answers получает варианты текущего вопроса после операции
+    virtual bool start(const QString& section, QStringList* answers) = 0;
+    virtual bool check(const QString& answer, QStringList* answers) = 0;
+    virtual bool next(bool* moved, QStringList* answers) = 0;
+    virtual void end() = 0;
+};
+
+class InProcessClient : public Client
+{
+public:
+    InProcessClient(SessionPool* pool, const QHash<QString, QSharedPointer<const QuestionBank>>* banks,
+                    int optionCount)
+        : m_pool(pool)
+        , m_banks(banks)
+        , m_optionCount(optionCount)
+    {
+    }
+
+    ~InProcessClient() override { end(); }
+
+    // Как и окно приложения, после каждой операции читаем текст вопроса и варианты
+    bool start(const QString& section, QStringList* answers) override
+    {
+        end();
+        m_id = m_pool->create(QuizSession::Mode::Test, { { section, m_banks->value(section) } }, 0, m_optionCount);
+        m_session = m_pool->find(m_id);
+        if (!m_session || m_session->isEmpty()) {
+            return false;
+        }
+        m_question = m_session->questionText();
+        *answers = m_session->answers();
+        return true;
+    }
+
+    bool check(const QString& answer, QStringList* answers) override
+    {
+        m_session->checkAnswer(answer);
+        m_question = m_session->questionText();
+        *answers = m_session->answers();
+        return true;
+    }
+
+    bool next(bool* moved, QStringList* answers) override
+    {
+        *moved = m_session->next();
+        m_question = m_session->questionText();
+        *answers = m_session->answers();
+        return true;
+    }
+
+    void end() override
+    {
+        if (m_session) {
+            m_pool->remove(m_id);
+            m_session.reset();
+        }
+    }
+
+private:
+    SessionPool* m_pool;
+    const QHash<QString, QSharedPointer<const QuestionBank>>* m_banks;
+    int m_optionCount;
+    SessionPool::SessionId m_id = 0;
+    QSharedPointer<QuizSession> m_session;
+    QString m_question;
+};
+
+// HTTP/1.1 с keep-alive на блокирующем сокете; создаётся в потоке, который его использует
+class HttpClient : public Client
+{
+public:
+    HttpClient(const QString& host, quint16 port)
+        : m_host(host)
+        , m_port(port)
+    {
+    }
+
+    ~HttpClient() override { end(); }
+
+    bool start(const QString& section, QStringList* answers) override
+    {
+        end();
+        QJsonObject args;
+        args["section"] = section;
+        QJsonObject result;
+        if (!request("POST", "/api/sessions", args, &result)) {
+            return false;
+        }
+        m_token = result["session"].toString().toLatin1();
+        readAnswers(result, answers);
+        return !m_token.isEmpty();
+    }
+
+    bool check(const QString& answer, QStringList* answers) override
+    {
+        QJsonObject args;
+        args["answer"] = answer;
+        QJsonObject result;
+        if (!request("POST", "/api/sessions/" + m_token + "/check", args, &result)) {
+            return false;
+        }
+        readAnswers(result, answers);
+        return true;
+    }
+
+    bool next(bool* moved, QStringList* answers) override
+    {
+        QJsonObject result;
+        if (!request("POST", "/api/sessions/" + m_token + "/next", QJsonObject(), &result)) {
+            return false;
+        }
+        *moved = result["moved"].toBool();
+        readAnswers(result, answers);
+        return true;
+    }
+
+    void end() override
+    {
+        if (!m_token.isEmpty()) {
+            QJsonObject result;
+            request("DELETE", "/api/sessions/" + m_token, QJsonObject(), &result);
+            m_token.clear();
+        }
+    }
+
+    bool request(const QByteArray& method, const QByteArray& path, const QJsonObject& args, QJsonObject* result)
+    {
+        if (m_socket.state() != QAbstractSocket::ConnectedState) {
+            m_buffer.clear();
+            m_socket.connectToHost(m_host, m_port);
+            if (!m_socket.waitForConnected(5000)) {
+                return false;
+            }
+            m_socket.setSocketOption(QAbstractSocket::LowDelayOption, 1);
+        }
+
+        const QByteArray body = args.isEmpty() ? QByteArray() : QJsonDocument(args).toJson(QJsonDocument::Compact);
+        QByteArray message = method + ' ' + path + " HTTP/1.1\r\nHost: " + m_host.toLatin1()
+            + "\r\nContent-Type: application/json\r\nContent-Length: " + QByteArray::number(body.size())
+            + "\r\n\r\n" + body;
+        m_socket.write(message);
+
+        qsizetype headerEnd;
+        while ((headerEnd = m_buffer.indexOf("\r\n\r\n")) < 0) {
+            if (!waitForData()) {
+                return false;
+            }
+        }
+        const QList<QByteArray> lines = m_buffer.left(headerEnd).split('\n');
+        const int status = lines.first().split(' ').value(1).toInt();
+        qsizetype contentLength = 0;
+        for (const QByteArray& line : lines) {
+            if (line.toLower().startsWith("content-length:")) {
+                contentLength = line.mid(15).trimmed().toLongLong();
+            }
+        }
+        const qsizetype responseSize = headerEnd + 4 + contentLength;
+        while (m_buffer.size() < responseSize) {
+            if (!waitForData()) {
+                return false;
+            }
+        }
+        *result = QJsonDocument::fromJson(m_buffer.mid(headerEnd + 4, contentLength)).object();
+        m_buffer.remove(0, responseSize);
+        return status >= 200 && status < 300;
+    }
+
+private:
+    bool waitForData()
+    {
+        if (!m_socket.waitForReadyRead(10000)) {
+            m_socket.abort();
+            return false;
+        }
+        m_buffer += m_socket.readAll();
+        return true;
+    }
+
+    static void readAnswers(const QJsonObject& state, QStringList* answers)
+    {
+        answers->clear();
+        for (const QJsonValue& value : state["answers"].toArray()) {
+            answers->append(value.toString());
+        }
+    }
+
+    QString m_host;
+    quint16 m_port;
+    QTcpSocket m_socket;
+    QByteArray m_buffer;
+    QByteArray m_token;
+};
+
+struct Settings {
+    QString host;
+    quint16 port = 0;
+    SessionPool* pool = nullptr;
+    const QHash<QString, QSharedPointer<const QuestionBank>>* banks = nullptr;
+    QStringList sections;
+    int optionCount = 4;
+    int candidates = 0;
+    qint64 thinkNs = 0;
+    qint64 durationNs = 0;
+};
+
+struct WorkerResult {
+    std::array<LatencyHistogram, OperationCount> latency;
+    quint64 testsCompleted = 0;
+    quint64 errors = 0;
+    quint64 late = 0;
+};
+
+// Виртуальный кандидат: начинает тест, отвечает на вопрос, переходит к следующему,
+// а после последнего вопроса начинает новый тест
+struct Candidate {
+    std::unique_ptr<Client> client;
+    QStringList answers;
+    bool started = false;
+    bool answered = false;
+};
+
+// Один поток обслуживает несколько кандидатов: следующим ходит тот, чьё время
+// размышления истекло раньше всех
+void runWorker(const Settings& settings, int firstCandidate, int candidateCount, const QElapsedTimer& clock,
+               WorkerResult* result)
+{
+    QRandomGenerator random(quint32(firstCandidate * 2654435761u + 1));
+    auto thinkTime = [&]() -> qint64 {
+        // Равномерно в [think/2, 3*think/2]
+        return settings.thinkNs > 0 ? settings.thinkNs / 2 + qint64(random.bounded(double(settings.thinkNs))) : 0;
+    };
+
+    std::vector<Candidate> candidates(candidateCount);
+    using Turn = std::pair<qint64, int>;
+    std::priority_queue<Turn, std::vector<Turn>, std::greater<Turn>> turns;
+    for (int i = 0; i < candidateCount; ++i) {
+        if (settings.pool) {
+            candidates[i].client.reset(new InProcessClient(settings.pool, settings.banks, settings.optionCount));
+        } else {
+            candidates[i].client.reset(new HttpClient(settings.host, settings.port));
+        }
+        // Старты разнесены по первому интервалу размышления, чтобы не было общего залпа
+        turns.push({ settings.thinkNs > 0 ? qint64(random.bounded(double(settings.thinkNs))) : 0, i });
+    }
+
+    while (!turns.empty()) {
+        const Turn turn = turns.top();
+        turns.pop();
+        if (turn.first >= settings.durationNs) {
+            continue;
+        }
+        qint64 now = clock.nsecsElapsed();
+        if (turn.first > now) {
+            QThread::usleep(quint64((turn.first - now) / 1000));
+        } else if (now - turn.first > 1000000) {
+            // Генератор не успевает за расписанием: задержки ниже занижены
+            ++result->late;
+        }
+
+        Candidate& candidate = candidates[turn.second];
+        Operation operation;
+        bool ok;
+        bool moved = true;
+        const qint64 begin = clock.nsecsElapsed();
+        if (!candidate.started) {
+            operation = StartSectionTest;
+            const QString& section = settings.sections[random.bounded(int(settings.sections.size()))];
+            ok = candidate.client->start(section, &candidate.answers);
+        } else if (!candidate.answered) {
+            operation = CheckAnswer;
+            const QString answer = candidate.answers.isEmpty()
+                ? QString() : candidate.answers[random.bounded(int(candidate.answers.size()))];
+            ok = candidate.client->check(answer, &candidate.answers);
+        } else {
+            operation = NextQuestion;
+            ok = candidate.client->next(&moved, &candidate.answers);
+        }
+        now = clock.nsecsElapsed();
+
+        if (!ok) {
+            ++result->errors;
+            candidate.started = false;
+        } else {
+            result->latency[operation].record(now - begin);
+            if (operation == StartSectionTest) {
+                candidate.started = true;
+                candidate.answered = false;
+            } else if (operation == CheckAnswer) {
+                candidate.answered = true;
+            } else if (moved) {
+                candidate.answered = false;
+            } else {
+                // Последний вопрос пройден: завершение сессии не измеряется
+                candidate.client->end();
+                candidate.started = false;
+                ++result->testsCompleted;
+            }
+        }
+        turns.push({ now + thinkTime(), turn.second });
+    }
+
+    for (Candidate& candidate : candidates) {
+        candidate.client->end();
+    }
+}
+
+QSharedPointer<const QuestionBank> syntheticBank(const QString& section, int questionCount)
+{
+    QVector<QuestionBank::Question> questions;
+    questions.reserve(questionCount);
+    for (int i = 1; i <= questionCount; ++i) {
+        QuestionBank::Question question;
+        question.text = section + ": question " + QString::number(i) + " about object lifetime and ownership";
+        question.options.append("Answer " + QString::number(i) + " of " + section);
+        question.correctOption = 0;
+        questions.append(question);
+    }
+    return QuestionBank::fromQuestions(questions);
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("quizown-loadgen");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Simulates concurrent test-takers and reports per-operation latency");
+    parser.addHelpOption();
+    QCommandLineOption urlOption("url", "Drive a running 'QuizOwn --serve' at host:port instead of in-process",
+                                 "host:port");
+    QCommandLineOption sectionsOption("sections", "Sections catalog for in-process mode (default: synthetic)", "file");
+    QCommandLineOption syntheticOption("synthetic", "Synthetic sections x questions (default: 8x200)", "SxQ", "8x200");
+    QCommandLineOption candidatesOption("candidates", "Virtual candidates (default: 100)", "count", "100");
+    QCommandLineOption threadsOption("threads", "Generator threads (default: number of cores)", "count", "0");
+    QCommandLineOption thinkOption("think", "Mean think time between operations in ms (default: 0)", "ms", "0");
+    QCommandLineOption durationOption("duration", "Test duration in seconds (default: 10)", "seconds", "10");
+    QCommandLineOption optionsOption("options", "Answer options per question (default: 4)", "count", "4");
+    QCommandLineOption histogramOption("histogram", "Also print non-empty histogram buckets");
+    parser.addOptions({ urlOption, sectionsOption, syntheticOption, candidatesOption, threadsOption, thinkOption,
+                        durationOption, optionsOption, histogramOption });
+    parser.process(app);
+
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    Settings settings;
+    settings.candidates = qMax(1, parser.value(candidatesOption).toInt());
+    settings.thinkNs = qint64(parser.value(thinkOption).toDouble() * 1e6);
+    settings.durationNs = qint64(parser.value(durationOption).toDouble() * 1e9);
+    settings.optionCount = qMax(2, parser.value(optionsOption).toInt());
+    int threadCount = parser.value(threadsOption).toInt();
+    if (threadCount <= 0) {
+        threadCount = QThread::idealThreadCount();
+    }
+    threadCount = qMin(threadCount, settings.candidates);
+
+    SessionPool pool;
+    QHash<QString, QSharedPointer<const QuestionBank>> banks;
+    QString target;
+    if (parser.isSet(urlOption)) {
+        const QString url = parser.value(urlOption);
+        const qsizetype colon = url.lastIndexOf(':');
+        settings.host = colon > 0 ? url.left(colon) : url;
+        settings.port = colon > 0 ? quint16(url.mid(colon + 1).toUInt()) : quint16(8080);
+
+        HttpClient probe(settings.host, settings.port);
+        QJsonObject result;
+        if (!probe.request("GET", "/api/sections", QJsonObject(), &result)) {
+            err << "Failed to reach QuizOwn server at " << url << Qt::endl;
+            return 1;
+        }
+        for (const QJsonValue& value : result["sections"].toArray()) {
+            settings.sections.append(value.toString());
+        }
+        target = "http://" + settings.host + ':' + QString::number(settings.port);
+    } else {
+        if (parser.isSet(sectionsOption)) {
+            QFile catalog(parser.value(sectionsOption));
+            if (!catalog.open(QIODevice::ReadOnly)) {
+                err << "Failed to open sections catalog: " << catalog.fileName() << Qt::endl;
+                return 1;
+            }
+            const QJsonObject catalogObject = QJsonDocument::fromJson(catalog.readAll()).object();
+            for (auto it = catalogObject.constBegin(); it != catalogObject.constEnd(); ++it) {
+                const QJsonObject entry = it.value().toObject();
+                const QSharedPointer<const QuestionBank> bank =
+                    QuestionBank::load(entry["questionsFile"].toString(), entry["answersFile"].toString());
+                if (bank && bank->size() > 0) {
+                    banks.insert(it.key(), bank);
+                }
+            }
+        } else {
+            const QStringList shape = parser.value(syntheticOption).split('x');
+            const int sectionCount = qMax(1, shape.value(0).toInt());
+            const int questionCount = qMax(1, shape.value(1).toInt());
+            for (int i = 1; i <= sectionCount; ++i) {
+                const QString name = "Section " + QString::number(i);
+                banks.insert(name, syntheticBank(name, questionCount));
+            }
+        }
+        settings.pool = &pool;
+        settings.banks = &banks;
+        settings.sections = banks.keys();
+        target = "in-process";
+    }
+    if (settings.sections.isEmpty()) {
+        err << "No sections to test against" << Qt::endl;
+        return 1;
+    }
+
+    out << "# target: " << target << ", sections: " << settings.sections.size()
+        << ", candidates: " << settings.candidates << ", threads: " << threadCount
+        << ", think: " << parser.value(thinkOption) << " ms" << Qt::endl;
+
+    // Кандидаты делятся между потоками поровну
+    std::unique_ptr<WorkerResult[]> results(new WorkerResult[threadCount]);
+    QVector<QThread*> threads;
+    QElapsedTimer clock;
+    clock.start();
+    for (int i = 0; i < threadCount; ++i) {
+        const int first = int(qint64(settings.candidates) * i / threadCount);
+        const int last = int(qint64(settings.candidates) * (i + 1) / threadCount);
+        WorkerResult* result = &results[i];
+        QThread* thread = QThread::create([&settings, &clock, first, last, result]() {
+            runWorker(settings, first, last - first, clock, result);
+        });
+        thread->start();
+        threads.append(thread);
+    }
+    for (QThread* thread : threads) {
+        thread->wait();
+        delete thread;
+    }
+    const double seconds = double(clock.nsecsElapsed()) / 1e9;
+
+    WorkerResult total;
+    for (int i = 0; i < threadCount; ++i) {
+        const WorkerResult& result = results[i];
+        for (int op = 0; op < OperationCount; ++op) {
+            total.latency[op].merge(result.latency[op]);
+        }
+        total.testsCompleted += result.testsCompleted;
+        total.errors += result.errors;
+        total.late += result.late;
+    }
+
+    quint64 operations = 0;
+    out << "operation,count,ops_per_s,p50_us,p95_us,p99_us,max_us" << Qt::endl;
+    for (int op = 0; op < OperationCount; ++op) {
+        const LatencyHistogram& histogram = total.latency[op];
+        operations += histogram.count();
+        out << kOperationNames[op] << ',' << histogram.count() << ',' << double(histogram.count()) / seconds << ','
+            << double(histogram.percentile(0.50)) / 1e3 << ',' << double(histogram.percentile(0.95)) / 1e3 << ','
+            << double(histogram.percentile(0.99)) / 1e3 << ',' << double(histogram.max()) / 1e3 << Qt::endl;
+    }
+    out << "# total: " << double(operations) / seconds << " ops/s, " << double(total.testsCompleted) / seconds
+        << " tests/s, errors: " << total.errors << ", late turns: " << total.late << Qt::endl;
+
+    if (parser.isSet(histogramOption)) {
+        out << "operation,bucket_from_us,bucket_to_us,count" << Qt::endl;
+        for (int op = 0; op < OperationCount; ++op) {
+            const LatencyHistogram& histogram = total.latency[op];
+            for (int bucket = 0; bucket < LatencyHistogram::BucketCount; ++bucket) {
+                if (histogram.bucketCount(bucket) > 0) {
+                    out << kOperationNames[op] << ',' << double(LatencyHistogram::lowerBound(bucket)) / 1e3 << ','
+                        << double(LatencyHistogram::upperBound(bucket)) / 1e3 << ','
+                        << histogram.bucketCount(bucket) << Qt::endl;
+                }
+            }
+        }
+    }
+    return total.errors == 0 ? 0 : 2;
+}
@@ -0,0 +1,265 @@
+#include "quizown_bench.h"
+#include "logger.h"
+#include "questionbank.h"
+#include "quizmanager.h"
+#include "quizsection.h"
+#include <QDir>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSettings>
+#include <QStandardPaths>
+#include <QtTest>
+#include <limits>
+
+namespace {
+
+// Запуск: quizown_bench -o results.csv,csv (или results.xml,xml) для машиночитаемых результатов
+QString sizeName(int questionCount)
+{
+    if (questionCount >= 1000000 && questionCount % 1000000 == 0) {
+        return QString::number(questionCount / 1000000) + "M";
+    }
+    if (questionCount >= 1000 && questionCount % 1000 == 0) {
+        return QString::number(questionCount / 1000) + "K";
+    }
+    return QString::number(questionCount);
+}
+
+// Синтетический банк: у каждого вопроса три варианта, первый правильный
+bool writeBank(const QString& questionsFile, const QString& answersFile, int questionCount, int firstNumber = 1)
+{
+    QFile questions(questionsFile);
+    QFile answers(answersFile);
+    if (!questions.open(QIODevice::WriteOnly) || !answers.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    QByteArray questionBlock;
+    QByteArray answerBlock;
+    for (int i = 1; i <= questionCount; ++i) {
+        const QByteArray number = QByteArray::number(i);
+        const QByteArray topic = QByteArray::number(firstNumber + i);
+        questionBlock += number + ". What does construct " + topic + " guarantee about object lifetime?\n";
+        answerBlock += number + ". Guarantee " + topic + " {ans}\n";
+        answerBlock += number + ". Distractor " + QByteArray::number((firstNumber + i) % 997) + "\n";
+        answerBlock += number + ". Undefined behaviour\n";
+        if (answerBlock.size() > (1 << 20) || i == questionCount) {
+            if (questions.write(questionBlock) != questionBlock.size()
+                || answers.write(answerBlock) != answerBlock.size()) {
+                return false;
+            }
+            questionBlock.clear();
+            answerBlock.clear();
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+void QuizOwnBench::initTestCase()
+{
+    QVERIFY(m_dir.isValid());
+
+    // Настройки, кэш разбора и sections.json не должны пересекаться с установленным приложением
+    QStandardPaths::setTestModeEnabled(true);
+    QSettings::setDefaultFormat(QSettings::IniFormat);
+    QSettings::setPath(QSettings::IniFormat, QSettings::UserScope, m_dir.path());
+    QVERIFY(QDir::setCurrent(m_dir.path()));
+    Logger::getInstance().setLogLevel(LogLevel::Warning);
+
+    const QString sizes = qEnvironmentVariable("QUIZOWN_BENCH_SIZES", "1000,100000,10000000");
+    for (const QString& size : sizes.split(',', Qt::SkipEmptyParts)) {
+        if (size.toInt() > 0) {
+            m_sizes.append(size.toInt());
+        }
+    }
+    QVERIFY(!m_sizes.isEmpty());
+}
+
+void QuizOwnBench::init()
+{
+    // Каждый бенчмарк начинает с пустого каталога: QuizManager сохраняет его при уничтожении
+    QFile::remove("sections.json");
+}
+
+void QuizOwnBench::addSizeRows()
+{
+    QTest::addColumn<int>("questionCount");
+    for (int size : m_sizes) {
+        QTest::newRow(qPrintable(sizeName(size))) << size;
+    }
+}
+
+QuizOwnBench::BankFiles QuizOwnBench::bankFiles(int questionCount)
+{
+    // Файлы банка создаются один раз на размер и переиспользуются всеми бенчмарками
+    auto it = m_banks.constFind(questionCount);
+    if (it != m_banks.constEnd()) {
+        return it.value();
+    }
+    const QString prefix = m_dir.filePath("bank_" + QString::number(questionCount));
+    const BankFiles files(prefix + "_questions.txt", prefix + "_answers.txt");
+    if (!writeBank(files.first, files.second, questionCount)) {
+        return BankFiles();
+    }
+    m_banks.insert(questionCount, files);
+    return files;
+}
+
+void QuizOwnBench::loadQuestionsFromFile_data()
+{
+    addSizeRows();
+}
+
+void QuizOwnBench::loadQuestionsFromFile()
+{
+    QFETCH(int, questionCount);
+    const BankFiles files = bankFiles(questionCount);
+    QVERIFY(!files.first.isEmpty());
+
+    QBENCHMARK {
+        QVector<QuestionBank::Question> questions;
+        QVERIFY(QuestionBank::loadQuestionsFromFile(files.first, questions));
+        QCOMPARE(questions.size(), questionCount);
+    }
+}
+
+void QuizOwnBench::getCurrentAnswers_data()
+{
+    addSizeRows();
+}
+
+void QuizOwnBench::getCurrentAnswers()
+{
+    QFETCH(int, questionCount);
+    const BankFiles files = bankFiles(questionCount);
+    QuizManager manager;
+    manager.setMemoryBudget(std::numeric_limits<qint64>::max());
+    QVERIFY(manager.addSection("bench", files.first, files.second));
+    QVERIFY(manager.startSectionTest("bench"));
+    QVERIFY(manager.goToQuestion(questionCount / 2));
+
+    QBENCHMARK {
+        const QStringList answers = manager.getCurrentAnswers();
+        QCOMPARE(answers.size(), manager.answerOptionCount());
+    }
+}
+
+void QuizOwnBench::getCurrentMarathonAnswers_data()
+{
+    addSizeRows();
+}
+
+void QuizOwnBench::getCurrentMarathonAnswers()
+{
+    QFETCH(int, questionCount);
+    const BankFiles files = bankFiles(questionCount);
+    QuizManager manager;
+    manager.setMemoryBudget(std::numeric_limits<qint64>::max());
+    QVERIFY(manager.addSection("bench", files.first, files.second));
+    QVERIFY(manager.startMarathon({ "bench" }));
+    QVERIFY(manager.goToMarathonQuestion(questionCount / 2));
+
+    QBENCHMARK {
+        const QStringList answers = manager.getCurrentMarathonAnswers();
+        QCOMPARE(answers.size(), 3);
+    }
+}
+
+void QuizOwnBench::marathonNavigation_data()
+{
+    QTest::addColumn<int>("sectionCount");
+    QTest::addColumn<int>("questionsPerSection");
+    QTest::newRow("10x1K") << 10 << 1000;
+    QTest::newRow("100x100") << 100 << 100;
+    QTest::newRow("1000x10") << 1000 << 10;
+}
+
+void QuizOwnBench::marathonNavigation()
+{
+    QFETCH(int, sectionCount);
+    QFETCH(int, questionsPerSection);
+
+    QuizManager manager;
+    manager.setMemoryBudget(std::numeric_limits<qint64>::max());
+    QStringList sections;
+    for (int i = 0; i < sectionCount; ++i) {
+        const QString name = QString("nav_%1_%2").arg(sectionCount).arg(i);
+        const QString prefix = m_dir.filePath(name);
+        QVERIFY(writeBank(prefix + "_questions.txt", prefix + "_answers.txt", questionsPerSection,
+                          i * questionsPerSection));
+        QVERIFY(manager.addSection(name, prefix + "_questions.txt", prefix + "_answers.txt"));
+        sections.append(name);
+    }
+    QVERIFY(manager.startMarathon(sections));
+
+    // Полный проход по марафону вперёд и прыжок обратно к началу
+    QBENCHMARK {
+        int moves = 0;
+        while (manager.nextMarathonQuestion()) {
+            ++moves;
+        }
+        QCOMPARE(moves, sectionCount * questionsPerSection - 1);
+        QVERIFY(manager.goToMarathonQuestion(0));
+    }
+}
+
+void QuizOwnBench::saveQuestions_data()
+{
+    QTest::addColumn<int>("sectionCount");
+    QTest::newRow("100") << 100;
+    QTest::newRow("10K") << 10000;
+}
+
+void QuizOwnBench::saveQuestions()
+{
+    QFETCH(int, sectionCount);
+    const BankFiles files = bankFiles(m_sizes.first());
+
+    // Каталог разделов пишется напрямую: тела разделов saveQuestions не нужны
+    QJsonObject catalog;
+    for (int i = 0; i < sectionCount; ++i) {
+        QJsonObject section;
+        section["questionsFile"] = files.first;
+        section["answersFile"] = files.second;
+        catalog[QString("Section %1").arg(i)] = section;
+    }
+    QFile file("sections.json");
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write(QJsonDocument(catalog).toJson());
+    file.close();
+
+    QuizManager manager;
+    QCOMPARE(manager.getSectionNames().size(), sectionCount);
+    QBENCHMARK {
+        QVERIFY(manager.saveQuestions());
+    }
+}
+
+void QuizOwnBench::quizSectionEdits_data()
+{
+    addSizeRows();
+}
+
+void QuizOwnBench::quizSectionEdits()
+{
+    QFETCH(int, questionCount);
+    QuizSection section("bench");
+    for (int i = 0; i < questionCount; ++i) {
+        section.addQuestion(QString("Question %1").arg(i), QString("Answer %1").arg(i % 4096));
+    }
+
+    // Правка вопроса и ответа, добавление и удаление последнего вопроса
+    int index = 0;
+    QBENCHMARK {
+        index = (index + 7919) % questionCount;
+        QVERIFY(section.setQuestion(index, QString("Edited question %1").arg(index)));
+        QVERIFY(section.setAnswer(index, QString("Edited answer %1").arg(index % 4096)));
+        QVERIFY(section.addQuestion("Appended question", "Appended answer"));
+        QVERIFY(section.removeQuestion(section.getQuestionCount() - 1));
+    }
+    QCOMPARE(section.getQuestionCount(), questionCount);
+}
+
+QTEST_GUILESS_MAIN(QuizOwnBench)
@@ -0,0 +1,44 @@
+#ifndef QUIZOWN_BENCH_H
+#define QUIZOWN_BENCH_H
+
+#include <QHash>
+#include <QObject>
+#include <QPair>
+#include <QTemporaryDir>
+#include <QVector>
+
+// Микробенчмарки движка на синтетических банках (QtTest QBENCHMARK).
+// Размеры банков задаются переменной окружения QUIZOWN_BENCH_SIZES, по умолчанию 1000,100000,10000000.
+class QuizOwnBench : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void init();
+
+    void loadQuestionsFromFile_data();
+    void loadQuestionsFromFile();
+    void getCurrentAnswers_data();
+    void getCurrentAnswers();
+    void getCurrentMarathonAnswers_data();
+    void getCurrentMarathonAnswers();
+    void marathonNavigation_data();
+    void marathonNavigation();
+    void saveQuestions_data();
+    void saveQuestions();
+    void quizSectionEdits_data();
+    void quizSectionEdits();
+
+private:
+    using BankFiles = QPair<QString, QString>;
+
+    void addSizeRows();
+    BankFiles bankFiles(int questionCount);
+
+    QTemporaryDir m_dir;
+    QVector<int> m_sizes;
+    QHash<int, BankFiles> m_banks;
+};
+
+#endif // QUIZOWN_BENCH_H
@@ -0,0 +1,83 @@
+#include "quizown_ui_bench.h"
+#include "answerstate.h"
+#include <QButtonGroup>
+#include <QFile>
+#include <QRadioButton>
+#include <QVBoxLayout>
+#include <QtTest>
+
+namespace {
+
+// Прежняя подсветка из MainWindow::onAnswerSubmitted
+const char* const kCorrectStyle = "QRadioButton { background-color: #4CAF50; color: white; }";
+const char* const kWrongStyle = "QRadioButton { background-color: #F44336; color: white; }";
+
+} // namespace
+
+void QuizOwnUiBench::initTestCase()
+{
+    // Та же таблица стилей, что загружает главное окно
+    QFile styleFile(QUIZOWN_STYLESHEET);
+    QVERIFY(styleFile.open(QFile::ReadOnly | QFile::Text));
+
+    m_window.reset(new QWidget);
+    m_window->setStyleSheet(QString::fromUtf8(styleFile.readAll()));
+    QVBoxLayout *layout = new QVBoxLayout(m_window.get());
+    QButtonGroup *group = new QButtonGroup(m_window.get());
+    for (int i = 0; i < 4; ++i) {
+        QRadioButton *button = new QRadioButton(
+            QString("%1. Guarantee about object lifetime after std::move, option %1").arg(i + 1), m_window.get());
+        group->addButton(button);
+        layout->addWidget(button);
+        m_buttons.append(button);
+    }
+    m_window->resize(640, 360);
+    m_window->show();
+    QVERIFY(QTest::qWaitForWindowExposed(m_window.get()));
+}
+
+void QuizOwnUiBench::cleanupTestCase()
+{
+    m_buttons.clear();
+    m_window.reset();
+}
+
+void QuizOwnUiBench::answerFeedback_data()
+{
+    QTest::addColumn<bool>("useProperty");
+    QTest::newRow("setStyleSheet") << false;
+    QTest::newRow("property") << true;
+}
+
+void QuizOwnUiBench::answerFeedback()
+{
+    QFETCH(bool, useProperty);
+
+    // Один цикл - неверный ответ с подсветкой и переход к следующему вопросу со сбросом,
+    // с синхронной перерисовкой после каждого шага
+    QBENCHMARK {
+        for (QRadioButton *button : std::as_const(m_buttons)) {
+            button->setEnabled(false);
+        }
+        if (useProperty) {
+            setAnswerState(m_buttons[1], "wrong");
+            setAnswerState(m_buttons[0], "correct");
+        } else {
+            m_buttons[1]->setStyleSheet(kWrongStyle);
+            m_buttons[0]->setStyleSheet(kCorrectStyle);
+        }
+        m_window->repaint();
+
+        for (QRadioButton *button : std::as_const(m_buttons)) {
+            button->setEnabled(true);
+            if (useProperty) {
+                setAnswerState(button, QString());
+            } else {
+                button->setStyleSheet(QString());
+            }
+        }
+        m_window->repaint();
+    }
+}
+
+QTEST_MAIN(QuizOwnUiBench)
@@ -0,0 +1,29 @@
+#ifndef QUIZOWN_UI_BENCH_H
+#define QUIZOWN_UI_BENCH_H
+
+#include <QObject>
+#include <QVector>
+#include <memory>
+
+class QRadioButton;
+class QWidget;
+
+// Задержка подсветки ответа: собственная таблица стилей на каждый вариант
+// против свойства state и селекторов общей таблицы стилей main.qss.
+class QuizOwnUiBench : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+
+    void answerFeedback_data();
+    void answerFeedback();
+
+private:
+    std::unique_ptr<QWidget> m_window;
+    QVector<QRadioButton*> m_buttons;
+};
+
+#endif // QUIZOWN_UI_BENCH_H
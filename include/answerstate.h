@@ -0,0 +1,22 @@
+#ifndef ANSWERSTATE_H
+#define ANSWERSTATE_H
+
+#include <QStyle>
+#include <QVariant>
+#include <QWidget>
+
+// Подсветка варианта ответа: динамическое свойство state ("correct", "wrong" или пусто)
+// сопоставляется селекторам QRadioButton[state="..."] общей таблицы стилей, поэтому
+// собственная таблица стилей виджета не разбирается заново при каждом ответе.
+inline void setAnswerState(QWidget *widget, const QString &state)
+{
+    if (widget->property("state").toString() == state) {
+        return;
+    }
+    widget->setProperty("state", state);
+    // Селекторы по свойствам пересчитываются при полировке; polish сам сбрасывает кэш правил виджета
+    widget->style()->polish(widget);
+    widget->update();
+}
+
+#endif // ANSWERSTATE_H
@@ -0,0 +1,69 @@
+#ifndef ANSWERSTATUSES_H
+#define ANSWERSTATUSES_H
+
+#include <QVector>
+#include <QtGlobal>
+
+// Статусы ответов сессии в двух битовых массивах: "отвечен" и "отвечен правильно"
+// (второй всегда подмножество первого). Миллион вопросов занимает 256 КБ, копия
+// разделяет данные до первой записи, а счётчики считаются popcount по 64 вопроса за раз.
+class AnswerStatuses
+{
+public:
+    enum Status {
+        Wrong = -1,
+        Unanswered = 0,
+        Correct = 1
+    };
+
+    struct Counts {
+        int correct = 0;
+        int wrong = 0;
+        int unanswered = 0;
+
+        int answered() const { return correct + wrong; }
+        int total() const { return answered() + unanswered; }
+    };
+
+    AnswerStatuses() = default;
+    explicit AnswerStatuses(int size) { clear(size); }
+
+    int size() const { return m_size; }
+    // Все вопросы становятся неотвеченными
+    void clear(int size);
+
+    // Номер вне [0, size()) считается неотвеченным вопросом, как в прежнем QVector::value
+    // (в отладочной сборке тоже, без Q_ASSERT)
+    bool isAnswered(int index) const
+    {
+        return contains(index) && ((m_answered[index >> 6] >> (index & 63)) & 1);
+    }
+    bool isCorrect(int index) const
+    {
+        return contains(index) && ((m_correct[index >> 6] >> (index & 63)) & 1);
+    }
+    Status status(int index) const
+    {
+        if (!contains(index)) {
+            return Unanswered;
+        }
+        return isAnswered(index) ? (isCorrect(index) ? Correct : Wrong) : Unanswered;
+    }
+    // Запись вне [0, size()) игнорируется
+    void set(int index, bool correct);
+
+    // Переносит статусы [from, from + count) из other в [to, to + count); диапазон назначения должен быть пуст
+    void copyRange(const AnswerStatuses& other, int from, int to, int count);
+
+    Counts counts() const { return counts(0, m_size); }
+    Counts counts(int from, int count) const;
+
+private:
+    bool contains(int index) const { return index >= 0 && index < m_size; }
+
+    QVector<quint64> m_answered;
+    QVector<quint64> m_correct;
+    int m_size = 0;
+};
+
+#endif // ANSWERSTATUSES_H
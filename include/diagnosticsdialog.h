@@ -0,0 +1,32 @@
+#ifndef DIAGNOSTICSDIALOG_H
+#define DIAGNOSTICSDIALOG_H
+
+#include <QDialog>
+#include <QPushButton>
+#include <QTableWidget>
+#include <QTimer>
+
+// Окно диагностики: квантили задержек основных операций из реестра Metrics
+class DiagnosticsDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit DiagnosticsDialog(QWidget *parent = nullptr);
+
+protected:
+    void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
+
+private slots:
+    void refresh();
+    void onReset();
+
+private:
+    QTableWidget *m_table;
+    QPushButton *m_resetButton;
+    QPushButton *m_closeButton;
+    QTimer *m_refreshTimer;
+};
+
+#endif // DIAGNOSTICSDIALOG_H
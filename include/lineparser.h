@@ -0,0 +1,50 @@
+#ifndef LINEPARSER_H
+#define LINEPARSER_H
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QIODevice>
+
+// Векторные примитивы поиска по UTF-8 буферу (AVX2/SSE2 с запасным скалярным вариантом)
+class LineScanner
+{
+public:
+    static const char* findByte(const char* begin, const char* end, char value);
+    static qsizetype indexOf(QByteArrayView haystack, QByteArrayView needle);
+    static bool isValidUtf8(const char* begin, const char* end);
+    static const char* implementation();
+};
+
+// Потоковое чтение непустых строк блоками без временного QByteArray на каждую строку.
+// Возвращаемая строка указывает во внутренний буфер и действительна до следующего вызова next().
+class LineReader
+{
+public:
+    explicit LineReader(QIODevice* device, qsizetype chunkSize = 1 << 20);
+
+    bool next(QByteArrayView& line);
+    bool hasInvalidUtf8() const { return m_invalidUtf8; }
+    // Чтение прервалось ошибкой устройства: next() вернул false раньше конца файла
+    bool hasError() const { return m_error; }
+    // Номер в файле (с единицы) последней строки, которую вернул next(), с учётом пропущенных пустых
+    qint64 lineNumber() const { return m_lineNumber; }
+    qint64 bytesRead() const { return m_bytesRead; }
+
+private:
+    bool refill();
+    void validate(qsizetype upTo);
+
+    QIODevice* m_device;
+    QByteArray m_buffer;
+    qsizetype m_chunkSize;
+    qsizetype m_position = 0;
+    qsizetype m_end = 0;
+    qsizetype m_validated = 0;
+    qint64 m_bytesRead = 0;
+    qint64 m_lineNumber = 0;
+    bool m_atEnd = false;
+    bool m_invalidUtf8 = false;
+    bool m_error = false;
+};
+
+#endif // LINEPARSER_H
@@ -5,6 +5,14 @@
 #include <QFile>
 #include <QDateTime>
 #include <QDebug>
+#include <QMutex>
+#include <QAtomicInteger>
+#include <QWaitCondition>
+#include <QVariant>
+#include <initializer_list>
+#include <memory>
+
+class QThread;
 
 enum class LogLevel {
     Debug,
@@ -13,13 +21,40 @@ enum class LogLevel {
     Error
 };
 
+// Поле структурированной записи: ключ - строковый литерал, значение форматируется фоновым потоком
+struct LogField {
+    const char* key = nullptr;
+    QVariant value;
+};
+
+// Уровни ниже этого удаляются при компиляции (опция CMake QUIZOWN_LOG_MIN_LEVEL)
+#ifndef QUIZOWN_LOG_MIN_LEVEL
+#define QUIZOWN_LOG_MIN_LEVEL 0
+#endif
+
+// Асинхронный логгер. log() только помещает запись в кольцевой буфер без блокировок,
+// в файл (и в консоль, если она включена) записи пишет фоновый поток пакетами.
+// При переполнении буфера отладочные и информационные записи отбрасываются (их число попадает в журнал),
+// предупреждения и ошибки ждут освобождения места. При завершении буфер дописывается.
 class Logger
 {
 public:
     static Logger& getInstance();
     ~Logger();
+    static constexpr int MaxFields = 6;
+
     void setLogLevel(LogLevel level);
+    // Дублировать ли готовые пакеты записей в stderr; по умолчанию выключено
+    void setConsoleOutput(bool enabled) { m_consoleOutput.storeRelaxed(enabled ? 1 : 0); }
+    bool isEnabled(LogLevel level) const { return int(level) >= m_logLevel.loadRelaxed(); }
     void log(LogLevel level, const QString& message);
+    // message должен быть строковым литералом; поля сверх MaxFields отбрасываются
+    void logFields(LogLevel level, const char* message, std::initializer_list<LogField> fields = {});
+
+    // Ждёт, пока записи, добавленные до вызова, окажутся в файле
+    void flush();
+    // Останавливает фоновый поток, дописав буфер; дальнейшие записи пишутся синхронно
+    void shutdown();
 
     void debug(const QString& message) { log(LogLevel::Debug, message); }
     void info(const QString& message) { log(LogLevel::Info, message); }
@@ -27,19 +62,58 @@ public:
     void error(const QString& message) { log(LogLevel::Error, message); }
 
 private:
+    struct Record;
+    class RecordQueue;
+
     explicit Logger();
     Logger(const Logger&) = delete;
     Logger& operator=(const Logger&) = delete;
 
     QString levelToString(LogLevel level);
-    
-    LogLevel m_logLevel;
+    void enqueue(Record& record);
+    void writerLoop();
+    void appendRecord(QByteArray& batch, const Record& record);
+    void writeBatch(const QByteArray& batch);
+    void wakeWriter();
+
+    QAtomicInteger<int> m_logLevel;
+    QAtomicInteger<int> m_consoleOutput;
     QFile m_logFile;
+    QMutex m_mutex;
+
+    std::unique_ptr<RecordQueue> m_queue;
+    QThread* m_writer = nullptr;
+    QWaitCondition m_wakeWriter;
+    QWaitCondition m_written;
+    QAtomicInteger<int> m_writerSleeping;
+    QAtomicInteger<int> m_stopping;
+    QAtomicInteger<int> m_producers;
+    QAtomicInteger<int> m_flushRequested;
+    QAtomicInteger<quint64> m_dropped;
+    QAtomicInteger<quint64> m_flushedCount;
+    qint64 m_cachedSecond = -1;
+    QByteArray m_cachedTimestamp;
 };
 
-#define LOG_DEBUG(msg) Logger::getInstance().debug(msg)
-#define LOG_INFO(msg) Logger::getInstance().info(msg)
-#define LOG_WARNING(msg) Logger::getInstance().warning(msg)
-#define LOG_ERROR(msg) Logger::getInstance().error(msg)
+// Аргументы вычисляются только если уровень включён
+#define QUIZOWN_LOG(level, call) \
+    do { \
+        if constexpr (int(level) >= QUIZOWN_LOG_MIN_LEVEL) { \
+            if (Logger::getInstance().isEnabled(level)) { \
+                Logger::getInstance().call; \
+            } \
+        } \
+    } while (0)
+
+#define LOG_DEBUG(msg) QUIZOWN_LOG(LogLevel::Debug, debug(msg))
+#define LOG_INFO(msg) QUIZOWN_LOG(LogLevel::Info, info(msg))
+#define LOG_WARNING(msg) QUIZOWN_LOG(LogLevel::Warning, warning(msg))
+#define LOG_ERROR(msg) QUIZOWN_LOG(LogLevel::Error, error(msg))
+
+// Структурированные записи: LOG_INFO_KV("Question shown", { { "section", name }, { "index", index } })
+#define LOG_DEBUG_KV(...) QUIZOWN_LOG(LogLevel::Debug, logFields(LogLevel::Debug, __VA_ARGS__))
+#define LOG_INFO_KV(...) QUIZOWN_LOG(LogLevel::Info, logFields(LogLevel::Info, __VA_ARGS__))
+#define LOG_WARNING_KV(...) QUIZOWN_LOG(LogLevel::Warning, logFields(LogLevel::Warning, __VA_ARGS__))
+#define LOG_ERROR_KV(...) QUIZOWN_LOG(LogLevel::Error, logFields(LogLevel::Error, __VA_ARGS__))
 
-#endif // LOGGER_H 
\ No newline at end of file
+#endif // LOGGER_H
\ No newline at end of file
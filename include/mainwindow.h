@@ -3,7 +3,7 @@
 
 #include <QMainWindow>
 #include <QStackedWidget>
-#include <QListWidget>
+#include <QListView>
 #include <QLineEdit>
 #include <QPushButton>
 #include <QLabel>
@@ -12,9 +12,14 @@
 #include <QDialog>
 #include <QVBoxLayout>
 #include <QButtonGroup>
+#include <QVector>
 #include "quizmanager.h"
 #include "sectiondialog.h"
 
+class DiagnosticsDialog;
+class SectionListModel;
+class QRadioButton;
+
 QT_BEGIN_NAMESPACE
 namespace Ui { class MainWindow; }
 QT_END_NAMESPACE
@@ -32,25 +37,32 @@ private slots:
     void onEditSection();
     void onRemoveSection();
     void onSectionSelected();
+    void onSectionFilterChanged(const QString &text);
     void onStartMarathon();
     void onAnswerSubmitted();
     void onNextQuestion();
     void onPreviousQuestion();
     void onAbout();
     void onSettings();
+    void onDiagnostics();
 
 private:
     void setupConnections();
     void updateUI();
+    void updateSectionActions();
+    void updateQuestionView();
+    QString selectedSectionName() const;
+    void selectSection(const QString &name);
     void showError(const QString &message);
     void showInfo(const QString &message);
 
     QuizManager *m_quizManager;
     SectionDialog *m_sectionDialog;
-    QButtonGroup *m_sectionButtonGroup;
+    DiagnosticsDialog *m_diagnosticsDialog = nullptr;
+    SectionListModel *m_sectionsModel;
     QButtonGroup *m_answerButtonGroup;
-    QWidget *m_sectionsContainer;
-    QVBoxLayout *m_sectionsLayout;
+    QLineEdit *m_sectionFilterEdit;
+    QListView *m_sectionsView;
     QVBoxLayout *m_answersLayout;
     QPushButton *m_addSectionButton;
     QPushButton *m_editSectionButton;
@@ -60,10 +72,14 @@ private:
     QPushButton *m_nextButton;
     QPushButton *m_previousButton;
     QLabel *m_questionLabel;
+    QLabel *m_correctAnswerLabel;
     QLabel *m_progressLabel;
     QLabel *m_scoreLabel;
     QCheckBox *m_marathonCheckBox;
     QStackedWidget *m_stackedWidget;
+
+    // Кнопки ответов переиспользуются между вопросами, а не пересоздаются
+    QVector<QRadioButton*> m_answerButtons;
 };
 
 #endif // MAINWINDOW_H 
\ No newline at end of file
@@ -0,0 +1,119 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <QAtomicInteger>
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+#include <array>
+#include <memory>
+#include <vector>
+
+// Гистограмма задержек в наносекундах в духе HDR: 16 корзин на каждую степень двойки,
+// относительная погрешность квантилей не больше 1/16 = 6.25%. Запись - несколько атомарных
+// операций без блокировок, поэтому её можно вызывать из любого потока.
+class LatencyHistogram
+{
+public:
+    static constexpr int SubBucketBits = 4;
+    static constexpr int SubBucketCount = 1 << SubBucketBits;
+    static constexpr int BucketCount = (64 - SubBucketBits + 1) * SubBucketCount;
+
+    LatencyHistogram() = default;
+    Q_DISABLE_COPY(LatencyHistogram)
+
+    void record(qint64 nanoseconds);
+    void merge(const LatencyHistogram& other);
+    void reset();
+
+    quint64 count() const { return m_count.loadRelaxed(); }
+    quint64 sum() const { return m_sum.loadRelaxed(); }
+    quint64 max() const { return m_max.loadRelaxed(); }
+    quint64 bucketCount(int bucket) const { return m_counts[bucket].loadRelaxed(); }
+
+    // Верхняя граница корзины, в которую попадает квантиль q (0..1)
+    quint64 percentile(double q) const;
+
+    static int bucketOf(quint64 value);
+    static quint64 lowerBound(int bucket);
+    static quint64 upperBound(int bucket);
+
+private:
+    std::array<QAtomicInteger<quint64>, BucketCount> m_counts {};
+    QAtomicInteger<quint64> m_count;
+    QAtomicInteger<quint64> m_sum;
+    QAtomicInteger<quint64> m_max;
+};
+
+// Замер времени до конца области видимости
+class ScopedTimer
+{
+public:
+    explicit ScopedTimer(LatencyHistogram& histogram)
+        : m_histogram(histogram)
+    {
+        m_timer.start();
+    }
+    ~ScopedTimer() { m_histogram.record(m_timer.nsecsElapsed()); }
+
+    Q_DISABLE_COPY(ScopedTimer)
+
+private:
+    LatencyHistogram& m_histogram;
+    QElapsedTimer m_timer;
+};
+
+// Реестр именованных гистограмм процесса и их выгрузка в формате Prometheus или JSON
+class Metrics
+{
+public:
+    struct Summary {
+        QString name;
+        QString help;
+        quint64 count = 0;
+        double sumSeconds = 0;
+        double p50Seconds = 0;
+        double p95Seconds = 0;
+        double p99Seconds = 0;
+        double maxSeconds = 0;
+    };
+
+    static Metrics& instance();
+
+    // Возвращает гистограмму по имени, создавая её при первом обращении; ссылка действительна всегда
+    LatencyHistogram& histogram(const QString& name, const QString& help = QString());
+
+    QVector<Summary> summaries() const;
+    void reset();
+
+    QByteArray toPrometheus() const;
+    QByteArray toJson() const;
+    // Формат выбирается по расширению: .json - JSON, иначе текстовый формат Prometheus
+    bool writeToFile(const QString& filePath) const;
+
+private:
+    struct Entry {
+        QString name;
+        QString help;
+        LatencyHistogram histogram;
+    };
+
+    Metrics() = default;
+    Q_DISABLE_COPY(Metrics)
+
+    mutable QMutex m_mutex;
+    std::vector<std::unique_ptr<Entry>> m_entries;
+};
+
+#define QUIZOWN_METRICS_CONCAT_(a, b) a##b
+#define QUIZOWN_METRICS_CONCAT(a, b) QUIZOWN_METRICS_CONCAT_(a, b)
+
+// Замер времени текущей области; гистограмма ищется по имени один раз на место вызова
+#define METRICS_SCOPED_TIMER(name, help) \
+    static LatencyHistogram& QUIZOWN_METRICS_CONCAT(metricsHistogram_, __LINE__) = \
+        Metrics::instance().histogram(name, help); \
+    ScopedTimer QUIZOWN_METRICS_CONCAT(metricsTimer_, __LINE__)(QUIZOWN_METRICS_CONCAT(metricsHistogram_, __LINE__))
+
+#endif // METRICS_H
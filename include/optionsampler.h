@@ -0,0 +1,34 @@
+#ifndef OPTIONSAMPLER_H
+#define OPTIONSAMPLER_H
+
+#include "sessionrandom.h"
+#include <array>
+
+// Выбор вариантов ответа без выделения памяти: индексы дистракторов выбираются
+// алгоритмом Флойда за O(k) шагов, результат хранится в массиве фиксированного размера.
+class OptionSampler
+{
+public:
+    static constexpr int MaxOptions = 16;
+
+    struct Sample {
+        std::array<int, MaxOptions> indices;
+        int count = 0;
+        int correctPosition = -1;
+    };
+
+    // Возвращает min(optionCount, population) различных индексов из [0, population),
+    // включая correctIndex на случайной позиции, в случайном порядке
+    static Sample sample(int population, int correctIndex, int optionCount, SessionRandom& generator);
+
+    // Компактная перестановка вариантов вопроса; для вопросов с числом вариантов
+    // больше MaxOptions перемешиваются только первые MaxOptions
+    struct Permutation {
+        std::array<quint8, MaxOptions> order;
+        int count = 0;
+    };
+
+    static Permutation permutation(int optionCount, SessionRandom& generator);
+};
+
+#endif // OPTIONSAMPLER_H
@@ -0,0 +1,26 @@
+#ifndef PARSECACHE_H
+#define PARSECACHE_H
+
+#include <QString>
+#include <QJsonObject>
+#include <QSharedPointer>
+
+class QuestionBank;
+
+// Постоянный кэш разобранных текстовых банков. Снимок хранится в формате .qzb
+// в QStandardPaths::CacheLocation и переиспользуется, пока исходные файлы не изменились.
+class ParseCache
+{
+public:
+    static QSharedPointer<const QuestionBank> load(const QString& questionsFile, const QString& answersFile);
+
+    static QString cacheDirectory();
+    static quint64 hashFile(const QString& filePath, bool* ok = nullptr);
+
+private:
+    static QString entryPath(const QString& questionsFile, const QString& answersFile);
+    static QJsonObject fileKey(const QString& filePath, bool withHash);
+    static bool isFresh(QJsonObject& stored, const QString& filePath, bool* updated);
+};
+
+#endif // PARSECACHE_H
@@ -0,0 +1,87 @@
+#ifndef QUESTIONBANK_H
+#define QUESTIONBANK_H
+
+#include <QString>
+#include <QStringList>
+#include <QStringView>
+#include <QVector>
+#include <QFile>
+#include <QSharedPointer>
+#include <QScopedPointer>
+#include "stringpool.h"
+
+// Неизменяемый банк вопросов раздела. Хранит либо разобранные текстовые файлы,
+// либо отображённый в память скомпилированный файл .qzb.
+class QuestionBank
+{
+public:
+    struct Question {
+        QString text;
+        QStringList options;
+        int correctOption = -1;
+    };
+
+    static const char* compiledSuffix() { return ".qzb"; }
+    static bool isCompiledFile(const QString& filePath);
+
+    static QSharedPointer<const QuestionBank> load(const QString& questionsFile, const QString& answersFile);
+    static QSharedPointer<const QuestionBank> fromQuestions(const QVector<Question>& questions);
+    static QSharedPointer<const QuestionBank> fromCompiledFile(const QString& filePath);
+
+    static bool loadQuestionsFromFile(const QString& filePath, QVector<Question>& questions);
+    static bool loadAnswersFromFile(const QString& filePath, QVector<Question>& questions);
+    static bool compile(const QString& questionsFile, const QString& answersFile, const QString& outputFile);
+    static bool writeCompiledFile(const QVector<Question>& questions, const QString& outputFile);
+
+    ~QuestionBank();
+
+    int size() const;
+    bool isEmpty() const { return size() == 0; }
+    bool isMapped() const { return m_mapped != nullptr; }
+    bool isValid() const;
+    qint64 memoryUsage() const { return m_memoryUsage; }
+
+    QStringView textView(int index) const;
+    QStringView optionView(int index, int option) const;
+    QString text(int index) const { return textView(index).toString(); }
+    QString option(int index, int option) const { return optionView(index, option).toString(); }
+    QString correctAnswer(int index) const;
+    QStringList options(int index) const;
+    QVector<Question> toQuestions() const;
+    int optionCount(int index) const;
+    int correctOption(int index) const;
+
+private:
+    struct Header;
+    struct QuestionRecord;
+    struct OptionRecord;
+
+    QuestionBank() = default;
+    Q_DISABLE_COPY(QuestionBank)
+
+    bool mapFile(const QString& filePath);
+    QStringView stringAt(quint32 offset, quint32 length) const;
+
+    // Разобранный текст: строки в пуле, вопрос ссылается на них 32-битными дескрипторами
+    struct PooledQuestion {
+        StringPool::Handle text;
+        quint32 firstOption;
+        quint16 optionCount;
+        qint16 correctOption;
+    };
+
+    QVector<PooledQuestion> m_pooledQuestions;
+    QVector<StringPool::Handle> m_pooledOptions;
+    StringPool m_strings;
+
+    QScopedPointer<QFile> m_file;
+    const uchar* m_mapped = nullptr;
+    const Header* m_header = nullptr;
+    const QuestionRecord* m_questionTable = nullptr;
+    const OptionRecord* m_optionTable = nullptr;
+    const QChar* m_mappedStrings = nullptr;
+
+    qint64 m_memoryUsage = 0;
+};
+
+#endif // QUESTIONBANK_H
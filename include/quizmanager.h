@@ -3,20 +3,41 @@
 
 #include <QObject>
 #include <QString>
-#include <QMap>
 #include <QVector>
+#include <QStringList>
+#include <QSharedPointer>
+#include <QFileSystemWatcher>
+#include <QHash>
+#include <QSet>
+#include <QTimer>
+#include <QScopedPointer>
+#include "questionbank.h"
+#include "quizsession.h"
 
 class QuizManager : public QObject
 {
     Q_OBJECT
 
 public:
+    // Плотный номер раздела в m_sections; имя переводится в номер только на входе API
+    using SectionId = int;
+    static constexpr SectionId InvalidSection = -1;
+
     struct Section {
         QString name;
         QString questionsFile;
         QString answersFile;
-        QVector<QString> questions;
-        QVector<QString> answers;
+        QSharedPointer<const QuestionBank> bank;
+
+        int questionCount() const { return bank ? bank->size() : 0; }
+        qint64 memoryUsage() const { return bank ? bank->memoryUsage() : 0; }
+        bool isLoaded() const { return !bank.isNull(); }
+        bool isValid() const { return !name.isEmpty(); }
+    };
+
+    struct SectionScore {
+        QString section;
+        AnswerStatuses::Counts counts;
     };
 
     explicit QuizManager(QObject* parent = nullptr);
@@ -26,9 +47,17 @@ public:
     bool removeSection(const QString& name);
     bool editSection(const QString& oldName, const QString& newName, const QString& questionsFile, const QString& answersFile);
     QStringList getSectionNames() const;
+    int sectionCount() const { return m_sectionIds.size(); }
+    // Номера существующих разделов без сортировки и копирования имён
+    QVector<SectionId> sectionIds() const { return m_sectionIds.values(); }
     QString getSectionQuestionsFile(const QString& name) const;
     QString getSectionAnswersFile(const QString& name) const;
     const Section& getCurrentSection() const;
+    SectionId sectionId(const QString& name) const { return m_sectionIds.value(name, InvalidSection); }
+    // Принимает банк, загруженный в другом потоке, если раздел с теми же файлами ещё не загружен
+    void adoptSectionBank(const QString& name, const QString& questionsFile, const QString& answersFile,
+                          const QSharedPointer<const QuestionBank>& bank);
+    const Section& section(SectionId id) const { return m_sections[id]; }
 
     bool startSectionTest(const QString& sectionName);
     bool startMarathon(const QStringList& sectionNames);
@@ -53,13 +82,29 @@ public:
     int getCurrentMarathonQuestionIndex() const;
     int getTotalQuestions() const;
     int getTotalMarathonQuestions() const;
-    QVector<int> getQuestionStatuses() const;
-    QVector<int> getMarathonStatuses() const;
+    // Копия разделяет биты с сессией, поэтому возврат по значению не копирует статусы
+    AnswerStatuses getQuestionStatuses() const;
+    AnswerStatuses getMarathonStatuses() const;
+    AnswerStatuses::Counts getMarathonCounts() const;
+    QVector<SectionScore> getMarathonSectionScores() const;
     QString getCurrentSectionName() const;
     QString getCurrentMarathonSectionName() const;
     int getCurrentSectionQuestionCount() const;
     int getCurrentMarathonSectionQuestionCount() const;
 
+    qint64 memoryBudget() const { return m_memoryBudget; }
+    void setMemoryBudget(qint64 bytes);
+    qint64 loadedSectionsMemory() const;
+
+    int answerOptionCount() const { return m_answerOptionCount; }
+    void setAnswerOptionCount(int count);
+
+    // Зерно перемешивания сессии; 0 - новое случайное зерно для каждой сессии
+    quint64 shuffleSeed() const { return m_shuffleSeed; }
+    void setShuffleSeed(quint64 seed) { m_shuffleSeed = seed; }
+    quint64 testSeed() const { return m_test ? m_test->seed() : 0; }
+    quint64 marathonSeed() const { return m_marathon ? m_marathon->seed() : 0; }
+
     bool isTestActive() const { return m_isTestActive; }
     bool isMarathonActive() const { return m_isMarathonActive; }
 
@@ -75,32 +120,64 @@ signals:
     void marathonStarted();
     void marathonEnded(int correctAnswers, int totalQuestions);
     void sectionAdded(const QString& name);
-    void sectionRemoved(const QString& name);
+    // Слот раздела к этому моменту уже очищен, поэтому вместе с именем передаётся его номер
+    void sectionRemoved(const QString& name, QuizManager::SectionId id);
     void sectionEdited(const QString& name);
+    void sectionReloaded(const QString& name);
     void answerChecked(bool correct);
     void error(const QString& message);
 
+private slots:
+    void onWatchedFileChanged(const QString& filePath);
+    void onWatchedDirectoryChanged(const QString& directory);
+    void reloadChangedFiles();
+
 private:
-    bool loadQuestionsFromFile(const QString& filePath, QVector<QString>& questions);
-    bool loadAnswersFromFile(const QString& filePath, QVector<QString>& answers);
-    void updateQuestionStatus(bool correct);
-    void updateMarathonStatus(bool correct);
+    static Section loadSection(const Section& entry);
+    SectionId insertSection(const Section& section);
+    void watchSection(SectionId id);
+    void unwatchSection(SectionId id);
+    bool reloadSection(SectionId id, bool questionsChanged, bool answersChanged);
+    bool loadSectionBodies(const QVector<SectionId>& ids);
+    void touchSection(SectionId id);
+    bool isSectionPinned(SectionId id) const;
+    void releaseBank(Section& section);
+    void enforceMemoryBudget();
+    void endMarathon();
+    void updateSessions(SectionId id);
 
 private:
-    QMap<QString, Section> m_sections;
-    QString m_currentSection;
-    int m_currentQuestionIndex;
-    int m_correctAnswers;
-    QVector<int> m_questionStatuses;
+    // Удалённые разделы оставляют пустой слот, который переиспользуется следующим добавлением
+    QVector<Section> m_sections;
+    QHash<QString, SectionId> m_sectionIds;
+    QVector<SectionId> m_freeSectionIds;
+    QVector<SectionId> m_recentSections;
+    // Выгруженные или заменённые банки, которые ещё держат сессии сервера; учитываются в бюджете, пока живы
+    struct ReleasedBank {
+        QWeakPointer<const QuestionBank> bank;
+        qint64 memoryUsage;
+    };
+    QVector<ReleasedBank> m_releasedBanks;
+    qint64 m_memoryBudget;
+    int m_answerOptionCount;
+    quint64 m_shuffleSeed;
+
+    QFileSystemWatcher m_fileWatcher;
+    QHash<QString, QVector<SectionId>> m_watchedFiles;
+    QSet<QString> m_changedFiles;
+    // Удалённые файлы разделов; пока их нет, наблюдается каталог, чтобы заметить их появление
+    QSet<QString> m_missingFiles;
+    QTimer m_reloadTimer;
+
+    // Состояние теста и марафона; номера разделов нужны для закрепления в памяти и перезагрузки
+    QScopedPointer<QuizSession> m_test;
+    SectionId m_currentSectionId;
     bool m_isTestActive;
 
-    QString m_currentMarathonSection;
-    int m_currentMarathonQuestionIndex;
-    int m_marathonCorrectAnswers;
-    QVector<int> m_marathonStatuses;
+    QScopedPointer<QuizSession> m_marathon;
+    QVector<SectionId> m_marathonSectionIds;
+    QSet<SectionId> m_marathonSections;
     bool m_isMarathonActive;
-    QStringList m_marathonSections;
-    int m_currentMarathonSectionIndex;
 };
 
 #endif // QUIZMANAGER_H 
\ No newline at end of file
@@ -7,6 +7,7 @@
 #include <QFile>
 #include <QTextStream>
 #include <QObject>
+#include "stringpool.h"
 
 class QuizSection : public QObject
 {
@@ -41,9 +42,13 @@ signals:
 
 private:
     QString m_name;
-    QVector<QPair<QString, QString>> m_questions;
+    // Вопрос и ответ хранятся дескрипторами в общем пуле строк раздела
+    QVector<QPair<StringPool::Handle, StringPool::Handle>> m_questions;
+    StringPool m_pool;
     
     bool validateIndex(int index) const;
+    void compactPool();
+    void compactPoolIfSparse();
     bool readFile(const QString& filename, QVector<QString>& lines);
     bool writeFile(const QString& filename, const QVector<QString>& lines);
 };
@@ -0,0 +1,155 @@
+#ifndef QUIZSERVER_H
+#define QUIZSERVER_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QJsonObject>
+#include <QMutex>
+#include <QSet>
+#include <QSharedPointer>
+#include <QTcpServer>
+#include <QTimer>
+#include <QVector>
+#include <QWaitCondition>
+#include "questionbank.h"
+#include "sessionpool.h"
+#include <functional>
+
+class QThread;
+class QTcpSocket;
+class QuizManager;
+
+// Неизменяемый снимок каталога разделов, общий для всех потоков сервера. Банков в нём нет:
+// раздел загружается потоком-обработчиком при первом start и передаётся менеджеру под его бюджет памяти.
+struct ServerCatalog {
+    struct Section {
+        QString questionsFile;
+        QString answersFile;
+    };
+
+    QHash<QString, Section> sections;
+    int answerOptionCount = 4;
+};
+
+// Операции над сессиями, общие для HTTP и WebSocket. Потокобезопасен: сессии
+// лежат в сегментированном пуле, каталог подменяется целиком под короткой блокировкой.
+class ServerState
+{
+public:
+    // Сообщает о банке, загруженном потоком-обработчиком; вызывается в этом потоке
+    using BankLoadedHandler = std::function<void(const QString& name, const ServerCatalog::Section& files,
+                                                 const QSharedPointer<const QuestionBank>& bank)>;
+
+    ServerState();
+
+    void setCatalog(const QSharedPointer<const ServerCatalog>& catalog);
+    QSharedPointer<const ServerCatalog> catalog() const;
+    void setBankLoadedHandler(const BankLoadedHandler& handler) { m_bankLoadedHandler = handler; }
+
+    // Ограничения задаются до запуска сервера; при заполненном пуле start отвечает 503
+    void setMaxSessions(int count) { m_sessions.setMaxSessions(count); }
+    int expireIdleSessions(qint64 maxIdleMs) { return m_sessions.removeIdle(maxIdleMs); }
+    bool isMetricsEnabled() const { return m_metricsEnabled; }
+    void setMetricsEnabled(bool enabled) { m_metricsEnabled = enabled; }
+
+    // Выполняет операцию op; token - идентификатор сессии клиента (заполняется при start)
+    QJsonObject handle(const QString& op, const QJsonObject& args, QString& token, int* status);
+
+private:
+    QJsonObject sessionState(const QString& token, const QuizSession& session) const;
+    QString makeToken(SessionPool::SessionId id) const;
+    QSharedPointer<QuizSession> findSession(const QString& token, SessionPool::SessionId* id) const;
+    QSharedPointer<const QuestionBank> bank(const QString& name);
+
+    mutable QMutex m_catalogMutex;
+    QSharedPointer<const ServerCatalog> m_catalog;
+    // Банки, которые держат начатые сессии; слабые ссылки не мешают менеджеру выгружать разделы
+    QHash<QString, QWeakPointer<const QuestionBank>> m_banks;
+    quint64 m_catalogGeneration = 0;
+    // Разделы, которые сейчас читает один из потоков; остальные ждут его результата
+    QSet<QString> m_loadingBanks;
+    QWaitCondition m_bankLoaded;
+    BankLoadedHandler m_bankLoadedHandler;
+    QByteArray m_tokenKey;
+    SessionPool m_sessions;
+    bool m_metricsEnabled = false;
+};
+
+// Одно клиентское соединение: HTTP/1.1 с keep-alive либо, после Upgrade, WebSocket
+class ServerConnection : public QObject
+{
+    Q_OBJECT
+
+public:
+    ServerConnection(qintptr socketDescriptor, ServerState* state, QObject* parent = nullptr);
+
+private slots:
+    void onReadyRead();
+
+private:
+    bool processHttp();
+    bool processWebSocket();
+    void handleHttpRequest(const QByteArray& method, const QByteArray& path,
+                           const QHash<QByteArray, QByteArray>& headers, const QByteArray& body);
+    void upgradeToWebSocket(const QHash<QByteArray, QByteArray>& headers);
+    void sendHttp(int status, const QByteArray& contentType, const QByteArray& body);
+    void sendFrame(quint8 opcode, const QByteArray& payload);
+    void closeWithError(int status);
+
+    QTcpSocket* m_socket;
+    ServerState* m_state;
+    QByteArray m_buffer;
+    QByteArray m_fragments;
+    QString m_token;
+    bool m_webSocket = false;
+    bool m_keepAlive = true;
+};
+
+// Поток-обработчик: принимает дескрипторы сокетов и обслуживает их в своём цикле событий
+class ServerWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ServerWorker(ServerState* state);
+
+public slots:
+    void addConnection(qintptr socketDescriptor);
+
+private:
+    ServerState* m_state;
+};
+
+// Сервер викторины: принимает соединения и раздаёт их по потокам-обработчикам
+class QuizServer : public QTcpServer
+{
+    Q_OBJECT
+
+public:
+    explicit QuizServer(QuizManager* manager, QObject* parent = nullptr);
+    ~QuizServer();
+
+    bool start(const QHostAddress& address, quint16 port, int threads = 0);
+
+    // Сессии без обращений дольше timeoutSeconds удаляются; 0 - не удалять
+    void setSessionLimits(int maxSessions, int idleTimeoutSeconds);
+    void setMetricsEnabled(bool enabled) { m_state.setMetricsEnabled(enabled); }
+
+protected:
+    void incomingConnection(qintptr socketDescriptor) override;
+
+private slots:
+    void refreshCatalog();
+    void expireIdleSessions();
+
+private:
+    QuizManager* m_manager;
+    ServerState m_state;
+    QTimer m_expiryTimer;
+    qint64 m_idleTimeoutMs = 0;
+    QVector<QThread*> m_threads;
+    QVector<ServerWorker*> m_workers;
+    int m_nextWorker = 0;
+};
+
+#endif // QUIZSERVER_H
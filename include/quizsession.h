@@ -0,0 +1,76 @@
+#ifndef QUIZSESSION_H
+#define QUIZSESSION_H
+
+#include <QSharedPointer>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include "answerstatuses.h"
+#include "questionbank.h"
+
+// Состояние одного прохождения (тест по разделу или марафон по нескольким разделам).
+// Банки вопросов неизменяемы и разделяются между сессиями и потоками, сама сессия
+// хранит только позицию, статусы ответов и зерно перемешивания. Сессия не
+// синхронизирована: в каждый момент ею управляет один кандидат (один поток).
+class QuizSession
+{
+public:
+    enum class Mode {
+        Test,       // варианты - правильные ответы других вопросов раздела
+        Marathon    // варианты - собственные варианты вопроса в перемешанном порядке
+    };
+
+    struct Part {
+        QString section;
+        QSharedPointer<const QuestionBank> bank;
+    };
+
+    QuizSession(Mode mode, const QVector<Part>& parts, quint64 seed, int optionCount = 4);
+
+    Mode mode() const { return m_mode; }
+    quint64 seed() const { return m_seed; }
+    bool isEmpty() const { return totalQuestions() == 0; }
+
+    int partCount() const { return m_parts.size(); }
+    const QString& partSection(int part) const { return m_parts[part].section; }
+    int currentPart() const { return m_currentPart; }
+    const QString& sectionName() const { return m_parts[m_currentPart].section; }
+    int sectionQuestionCount() const { return m_parts[m_currentPart].bank->size(); }
+    int questionIndex() const { return m_questionIndex; }
+    int globalIndex() const { return m_offsets[m_currentPart] + m_questionIndex; }
+    int totalQuestions() const { return m_offsets.last(); }
+
+    QString questionText() const;
+    QString correctAnswer() const;
+    QStringList answers() const;
+
+    // Засчитывается первый ответ на вопрос; повторные ответы только проверяются
+    bool checkAnswer(const QString& answer);
+    int correctAnswers() const { return m_statuses.counts().correct; }
+    const AnswerStatuses& statuses() const { return m_statuses; }
+    AnswerStatuses::Counts counts() const { return m_statuses.counts(); }
+    AnswerStatuses::Counts partCounts(int part) const;
+
+    bool next();
+    bool previous();
+    bool goTo(int globalIndex);
+    void reset();
+
+    // Подменяет раздел после перезагрузки или правки; статусы раздела переносятся по номерам вопросов
+    void replacePart(int part, const Part& replacement);
+
+private:
+    const QuestionBank& bank() const { return *m_parts[m_currentPart].bank; }
+    void rebuildOffsets();
+
+    Mode m_mode;
+    quint64 m_seed;
+    int m_optionCount;
+    QVector<Part> m_parts;
+    QVector<int> m_offsets;
+    AnswerStatuses m_statuses;
+    int m_currentPart = 0;
+    int m_questionIndex = 0;
+};
+
+#endif // QUIZSESSION_H
@@ -0,0 +1,60 @@
+#ifndef SECTIONLISTMODEL_H
+#define SECTIONLISTMODEL_H
+
+#include <QAbstractListModel>
+#include <QBitArray>
+#include <QVector>
+#include "quizmanager.h"
+
+// Список разделов для QListView. Модель хранит только номера разделов в порядке имён,
+// а текст строки берётся из QuizManager при отрисовке, поэтому на раздел приходится
+// несколько байт, а не виджет. Изменения каталога применяются построчно по сигналам менеджера.
+class SectionListModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    explicit SectionListModel(QuizManager *manager, QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    Qt::ItemFlags flags(const QModelIndex &index) const override;
+    bool setData(const QModelIndex &index, const QVariant &value, int role = Qt::EditRole) override;
+
+    QString sectionName(int row) const;
+    int rowOf(const QString &name) const;
+
+    // Подстрока без учёта регистра; уточнение фильтра просматривает только видимые строки
+    QString filter() const { return m_filter; }
+    void setFilter(const QString &text);
+
+    // Флажки для выбора разделов марафона; новые разделы отмечены
+    void setCheckable(bool checkable);
+    void setVisibleChecked(bool checked);
+    QStringList checkedSectionNames() const;
+
+private slots:
+    void onSectionAdded(const QString &name);
+    void onSectionRemoved(const QString &name, QuizManager::SectionId id);
+    void onSectionEdited(const QString &name);
+
+private:
+    using SectionId = QuizManager::SectionId;
+
+    const QString &nameOf(SectionId id) const { return m_manager->section(id).name; }
+    bool matches(SectionId id) const;
+    int lowerBound(const QVector<SectionId> &ids, const QString &name) const;
+    void insertSection(SectionId id, bool checked);
+    void removeAt(int orderIndex, SectionId id);
+    bool isChecked(SectionId id) const { return id < m_checked.size() && m_checked.testBit(id); }
+    void setChecked(SectionId id, bool checked);
+
+    QuizManager *m_manager;
+    QVector<SectionId> m_order;   // все разделы, по возрастанию имени
+    QVector<SectionId> m_rows;    // разделы, прошедшие фильтр, в том же порядке
+    QString m_filter;
+    bool m_checkable = false;
+    QBitArray m_checked;          // по номеру раздела
+};
+
+#endif // SECTIONLISTMODEL_H
@@ -0,0 +1,59 @@
+#ifndef SESSIONPOOL_H
+#define SESSIONPOOL_H
+
+#include <QAtomicInteger>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMutex>
+#include <QSharedPointer>
+#include <QVector>
+#include <memory>
+#include "quizsession.h"
+
+// Пул одновременных сессий. Таблица разбита на сегменты со своими блокировками,
+// поэтому потоки, работающие с разными сессиями, почти никогда не ждут друг друга.
+// Блокировка сегмента держится только на время поиска; сама сессия управляется
+// без блокировок своим владельцем.
+class SessionPool
+{
+public:
+    using SessionId = quint64;
+    static constexpr SessionId InvalidSession = 0;
+
+    explicit SessionPool(int shardCount = 0);
+
+    // Предел числа сессий; 0 - без ограничения. При заполненном пуле create возвращает InvalidSession
+    int maxSessions() const { return m_maxSessions; }
+    void setMaxSessions(int count) { m_maxSessions = qMax(0, count); }
+
+    SessionId create(QuizSession::Mode mode, const QVector<QuizSession::Part>& parts, quint64 seed = 0,
+                     int optionCount = 4);
+    // Поиск отмечает сессию как использованную для removeIdle
+    QSharedPointer<QuizSession> find(SessionId id) const;
+    bool remove(SessionId id);
+    // Удаляет сессии, к которым не обращались дольше maxIdleMs; возвращает число удалённых
+    int removeIdle(qint64 maxIdleMs);
+    int size() const { return m_size.loadRelaxed(); }
+
+private:
+    struct Entry {
+        QSharedPointer<QuizSession> session;
+        qint64 lastUsed;
+    };
+
+    struct Shard {
+        mutable QMutex mutex;
+        QHash<SessionId, Entry> sessions;
+    };
+
+    Shard& shardFor(SessionId id) const { return m_shards[id & m_shardMask]; }
+
+    std::unique_ptr<Shard[]> m_shards;
+    SessionId m_shardMask;
+    QAtomicInteger<quint64> m_nextId;
+    QAtomicInt m_size;
+    int m_maxSessions = 0;
+    QElapsedTimer m_clock;
+};
+
+#endif // SESSIONPOOL_H
@@ -0,0 +1,27 @@
+#ifndef SESSIONRANDOM_H
+#define SESSIONRANDOM_H
+
+#include <QtGlobal>
+#include <QStringView>
+
+// Быстрый воспроизводимый генератор сессии (xoshiro128**). Для каждого вопроса
+// создаётся собственный поток из (зерно сессии, раздел, номер вопроса), поэтому
+// порядок вариантов не зависит от порядка и числа перерисовок.
+class SessionRandom
+{
+public:
+    explicit SessionRandom(quint64 seed);
+
+    static SessionRandom forQuestion(quint64 sessionSeed, QStringView section, int questionIndex);
+    static quint64 newSeed();
+
+    quint32 generate();
+    quint32 bounded(quint32 highest);
+
+private:
+    static quint64 splitMix(quint64& state);
+
+    quint32 m_state[4];
+};
+
+#endif // SESSIONRANDOM_H
@@ -0,0 +1,91 @@
+#ifndef SHEETGRADER_H
+#define SHEETGRADER_H
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QHash>
+#include <QSharedPointer>
+#include <QString>
+#include <QVector>
+#include "questionbank.h"
+
+// Пакетная проверка бланков ответов без интерфейса и сигналов Qt.
+// Банки разделов загружаются один раз, строки бланков проверяются параллельно.
+//
+// CSV:   candidate,section,ответ1,ответ2,...   (пустое поле - вопрос без ответа)
+// JSONL: {"candidate":"...","section":"...","answers":["текст", 2, null, ...]}
+//        строка - текст варианта, число - номер варианта с нуля, null - без ответа
+class SheetGrader
+{
+public:
+    enum class Format { Csv, JsonLines };
+
+    struct Result {
+        QString candidate;
+        int section = -1;
+        int correct = 0;
+        int answered = 0;
+    };
+
+    struct QuestionStats {
+        qint64 attempts = 0;
+        qint64 correct = 0;
+    };
+
+    static Format formatForFile(const QString& filePath);
+
+    int addSection(const QString& name, const QSharedPointer<const QuestionBank>& bank);
+    int sectionCount() const { return m_sections.size(); }
+    QString sectionName(int section) const { return m_sections[section].name; }
+    const QuestionBank& bank(int section) const { return *m_sections[section].bank; }
+    // Сливает счётчики потоков-обработчиков раздела в общую статистику
+    const QVector<QuestionStats>& statistics(int section);
+    qint64 sheetsGraded() const { return m_sheetsGraded; }
+
+    // Проверяет пакет строк на всех ядрах; результаты идут в порядке строк,
+    // номера отклонённых строк (индексы в пакете) попадают в rejected
+    QVector<Result> grade(const QVector<QByteArray>& lines, Format format, QVector<int>* rejected = nullptr);
+
+private:
+    struct Section {
+        QString name;
+        QSharedPointer<const QuestionBank> bank;
+        QVector<QByteArray> correctUtf8;
+        QVector<QuestionStats> stats;
+    };
+
+    struct Chunk {
+        int begin = 0;
+        int end = 0;
+    };
+
+    struct ChunkResult {
+        QVector<Result> results;
+        QVector<int> rejected;
+    };
+
+    // Счётчики одного потока-обработчика по разделам; живут между пакетами,
+    // поэтому память не зависит от числа кусков и пакетов
+    using WorkerStats = QHash<int, QVector<QuestionStats>>;
+
+    // Ответ бланка: текст варианта (UTF-8), номер варианта или пропуск
+    struct Answer {
+        QByteArray text;
+        int option = -1;
+        bool isText = false;
+    };
+
+    enum class LineStatus { Parsed, Header, Rejected };
+
+    ChunkResult gradeChunk(const QVector<QByteArray>& lines, Format format, const Chunk& chunk,
+                           WorkerStats& stats) const;
+    static LineStatus parseCsv(QByteArrayView line, QString& candidate, QString& section, QVector<Answer>& answers);
+    static LineStatus parseJson(QByteArrayView line, QString& candidate, QString& section, QVector<Answer>& answers);
+
+    QVector<Section> m_sections;
+    QHash<QString, int> m_sectionIds;
+    QVector<WorkerStats> m_workerStats;
+    qint64 m_sheetsGraded = 0;
+};
+
+#endif // SHEETGRADER_H
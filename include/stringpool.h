@@ -0,0 +1,48 @@
+#ifndef STRINGPOOL_H
+#define STRINGPOOL_H
+
+#include <QString>
+#include <QStringView>
+#include <QVector>
+
+// Пул строк: текст хранится подряд в одном UTF-16 буфере, повторяющиеся строки
+// хранятся один раз, а на строку ссылаются компактные 32-битные дескрипторы.
+class StringPool
+{
+public:
+    using Handle = quint32;
+    static constexpr Handle InvalidHandle = 0xFFFFFFFFu;
+
+    StringPool() = default;
+
+    Handle intern(QStringView text);
+    QStringView view(Handle handle) const;
+    QString string(Handle handle) const { return view(handle).toString(); }
+    quint32 offset(Handle handle) const { return m_entries[handle].offset; }
+    QStringView data() const { return m_data; }
+
+    int size() const { return m_entries.size(); }
+    qint64 characterCount() const { return m_data.size(); }
+    qint64 memoryUsage() const;
+
+    void reserve(qsizetype strings, qsizetype characters);
+    void squeeze();
+    void clear();
+
+private:
+    struct Entry {
+        quint32 offset;
+        quint32 length;
+        quint32 hash;
+    };
+
+    static quint32 hashOf(QStringView text);
+    qsizetype findSlot(QStringView text, quint32 hash) const;
+    void rehash(qsizetype slotCount);
+
+    QString m_data;
+    QVector<Entry> m_entries;
+    QVector<Handle> m_slots;
+};
+
+#endif // STRINGPOOL_H
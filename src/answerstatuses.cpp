@@ -0,0 +1,67 @@
+#include "answerstatuses.h"
+#include <QtAlgorithms>
+
+void AnswerStatuses::clear(int size)
+{
+    m_size = qMax(0, size);
+    const int words = (m_size + 63) / 64;
+    m_answered.fill(0, words);
+    m_correct.fill(0, words);
+}
+
+void AnswerStatuses::set(int index, bool correct)
+{
+    if (!contains(index)) {
+        return;
+    }
+
+    const quint64 bit = quint64(1) << (index & 63);
+    m_answered[index >> 6] |= bit;
+    if (correct) {
+        m_correct[index >> 6] |= bit;
+    } else {
+        m_correct[index >> 6] &= ~bit;
+    }
+}
+
+void AnswerStatuses::copyRange(const AnswerStatuses& other, int from, int to, int count)
+{
+    // Только при перезагрузке раздела, поэтому побитно
+    for (int i = 0; i < count; ++i) {
+        if (other.isAnswered(from + i)) {
+            set(to + i, other.isCorrect(from + i));
+        }
+    }
+}
+
+AnswerStatuses::Counts AnswerStatuses::counts(int from, int count) const
+{
+    Counts result;
+    from = qBound(0, from, m_size);
+    count = qBound(0, count, m_size - from);
+    if (count == 0) {
+        return result;
+    }
+
+    // Крайние слова диапазона обрезаются масками, внутренние считаются целиком
+    const int end = from + count;
+    const int firstWord = from >> 6;
+    const int lastWord = (end - 1) >> 6;
+    int answered = 0;
+    int correct = 0;
+    for (int word = firstWord; word <= lastWord; ++word) {
+        quint64 mask = ~quint64(0);
+        if (word == firstWord) {
+            mask &= ~quint64(0) << (from & 63);
+        }
+        if (word == lastWord && (end & 63) != 0) {
+            mask &= ~quint64(0) >> (64 - (end & 63));
+        }
+        answered += qPopulationCount(m_answered[word] & mask);
+        correct += qPopulationCount(m_correct[word] & mask);
+    }
+    result.correct = correct;
+    result.wrong = answered - correct;
+    result.unanswered = count - answered;
+    return result;
+}
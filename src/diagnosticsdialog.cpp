@@ -0,0 +1,92 @@
+#include "diagnosticsdialog.h"
+#include "metrics.h"
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QVBoxLayout>
+
+namespace {
+
+QTableWidgetItem* numberItem(const QString& text)
+{
+    QTableWidgetItem *item = new QTableWidgetItem(text);
+    item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+    return item;
+}
+
+QString milliseconds(double seconds)
+{
+    return QString::number(seconds * 1000.0, 'f', 3);
+}
+
+} // namespace
+
+DiagnosticsDialog::DiagnosticsDialog(QWidget *parent)
+    : QDialog(parent)
+{
+    setWindowTitle(tr("Диагностика"));
+    resize(720, 320);
+
+    QVBoxLayout *mainLayout = new QVBoxLayout(this);
+
+    m_table = new QTableWidget(this);
+    m_table->setColumnCount(6);
+    m_table->setHorizontalHeaderLabels({ tr("Операция"), tr("Вызовов"), tr("p50, мс"), tr("p95, мс"),
+                                         tr("p99, мс"), tr("Макс., мс") });
+    m_table->horizontalHeader()->setSectionResizeMode(0, QHeaderView::Stretch);
+    m_table->verticalHeader()->setVisible(false);
+    m_table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_table->setSelectionMode(QAbstractItemView::NoSelection);
+    mainLayout->addWidget(m_table);
+
+    QHBoxLayout *buttonsLayout = new QHBoxLayout;
+    m_resetButton = new QPushButton(tr("Сбросить"), this);
+    m_closeButton = new QPushButton(tr("Закрыть"), this);
+    buttonsLayout->addStretch();
+    buttonsLayout->addWidget(m_resetButton);
+    buttonsLayout->addWidget(m_closeButton);
+    mainLayout->addLayout(buttonsLayout);
+
+    // Пока окно открыто, таблица обновляется раз в секунду
+    m_refreshTimer = new QTimer(this);
+    m_refreshTimer->setInterval(1000);
+
+    connect(m_refreshTimer, &QTimer::timeout, this, &DiagnosticsDialog::refresh);
+    connect(m_resetButton, &QPushButton::clicked, this, &DiagnosticsDialog::onReset);
+    connect(m_closeButton, &QPushButton::clicked, this, &QDialog::accept);
+}
+
+void DiagnosticsDialog::showEvent(QShowEvent *event)
+{
+    QDialog::showEvent(event);
+    refresh();
+    m_refreshTimer->start();
+}
+
+void DiagnosticsDialog::hideEvent(QHideEvent *event)
+{
+    m_refreshTimer->stop();
+    QDialog::hideEvent(event);
+}
+
+void DiagnosticsDialog::refresh()
+{
+    const QVector<Metrics::Summary> summaries = Metrics::instance().summaries();
+    m_table->setRowCount(summaries.size());
+    for (int row = 0; row < summaries.size(); ++row) {
+        const Metrics::Summary &summary = summaries[row];
+        QTableWidgetItem *nameItem = new QTableWidgetItem(summary.help.isEmpty() ? summary.name : summary.help);
+        nameItem->setToolTip(summary.name);
+        m_table->setItem(row, 0, nameItem);
+        m_table->setItem(row, 1, numberItem(QString::number(summary.count)));
+        m_table->setItem(row, 2, numberItem(milliseconds(summary.p50Seconds)));
+        m_table->setItem(row, 3, numberItem(milliseconds(summary.p95Seconds)));
+        m_table->setItem(row, 4, numberItem(milliseconds(summary.p99Seconds)));
+        m_table->setItem(row, 5, numberItem(milliseconds(summary.maxSeconds)));
+    }
+}
+
+void DiagnosticsDialog::onReset()
+{
+    Metrics::instance().reset();
+    refresh();
+}
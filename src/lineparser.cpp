@@ -0,0 +1,314 @@
+#include "lineparser.h"
+#include <QtAlgorithms>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define QUIZOWN_LINEPARSER_AVX2
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define QUIZOWN_LINEPARSER_SSE2
+#endif
+
+namespace {
+
+bool isSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\v' || c == '\f';
+}
+
+// Длина в байтах пробельного символа QChar::isSpace(), закодированного в UTF-8 с позиции p, иначе 0.
+// Так обрезка строк совпадает с QString::trimmed(): U+0085, U+00A0, U+1680, U+2000-U+200A,
+// U+2028, U+2029, U+202F, U+205F и U+3000 тоже считаются пробелами.
+int spaceLength(const unsigned char* p, const unsigned char* end)
+{
+    if (p >= end) {
+        return 0;
+    }
+    if (p[0] < 0x80) {
+        return isSpace(char(p[0])) ? 1 : 0;
+    }
+    if (end - p >= 2 && p[0] == 0xC2) {
+        return p[1] == 0x85 || p[1] == 0xA0 ? 2 : 0;
+    }
+    if (end - p < 3) {
+        return 0;
+    }
+    if (p[0] == 0xE1) {
+        return p[1] == 0x9A && p[2] == 0x80 ? 3 : 0;
+    }
+    if (p[0] == 0xE2) {
+        if (p[1] == 0x80) {
+            return p[2] <= 0x8A || p[2] == 0xA8 || p[2] == 0xA9 || p[2] == 0xAF ? 3 : 0;
+        }
+        return p[1] == 0x81 && p[2] == 0x9F ? 3 : 0;
+    }
+    if (p[0] == 0xE3) {
+        return p[1] == 0x80 && p[2] == 0x80 ? 3 : 0;
+    }
+    return 0;
+}
+
+// То же для символа, который заканчивается перед end
+int trailingSpaceLength(const unsigned char* begin, const unsigned char* end)
+{
+    if (end == begin) {
+        return 0;
+    }
+    if (end[-1] < 0x80) {
+        return isSpace(char(end[-1])) ? 1 : 0;
+    }
+    for (int length = 2; length <= 3 && end - begin >= length; ++length) {
+        if (spaceLength(end - length, end) == length) {
+            return length;
+        }
+    }
+    return 0;
+}
+
+bool isContinuation(unsigned char c)
+{
+    return (c & 0xC0) == 0x80;
+}
+
+// Пропускает ASCII-префикс блоками по 32/16 байт, возвращает первый байт со старшим битом.
+// Первые 16 байт проверяются по одному: в кириллице между многобайтовыми символами обычно
+// один-два пробела, и векторная загрузка на каждом слове обходится дороже
+const char* skipAscii(const char* p, const char* end)
+{
+    for (const char* scalarEnd = p + qMin<qsizetype>(end - p, 16); p < scalarEnd; ++p) {
+        if (static_cast<unsigned char>(*p) >= 0x80) {
+            return p;
+        }
+    }
+#if defined(QUIZOWN_LINEPARSER_AVX2)
+    while (end - p >= 32) {
+        const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        const quint32 mask = quint32(_mm256_movemask_epi8(chunk));
+        if (mask) {
+            return p + qCountTrailingZeroBits(mask);
+        }
+        p += 32;
+    }
+#endif
+#if defined(QUIZOWN_LINEPARSER_SSE2)
+    while (end - p >= 16) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        const quint32 mask = quint32(_mm_movemask_epi8(chunk));
+        if (mask) {
+            return p + qCountTrailingZeroBits(mask);
+        }
+        p += 16;
+    }
+#endif
+    while (p < end && static_cast<unsigned char>(*p) < 0x80) {
+        ++p;
+    }
+    return p;
+}
+
+} // namespace
+
+const char* LineScanner::findByte(const char* begin, const char* end, char value)
+{
+    const char* p = begin;
+#if defined(QUIZOWN_LINEPARSER_AVX2)
+    const __m256i pattern256 = _mm256_set1_epi8(value);
+    while (end - p >= 32) {
+        const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        const quint32 mask = quint32(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, pattern256)));
+        if (mask) {
+            return p + qCountTrailingZeroBits(mask);
+        }
+        p += 32;
+    }
+#endif
+#if defined(QUIZOWN_LINEPARSER_SSE2)
+    const __m128i pattern128 = _mm_set1_epi8(value);
+    while (end - p >= 16) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        const quint32 mask = quint32(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, pattern128)));
+        if (mask) {
+            return p + qCountTrailingZeroBits(mask);
+        }
+        p += 16;
+    }
+#endif
+    while (p < end && *p != value) {
+        ++p;
+    }
+    return p;
+}
+
+qsizetype LineScanner::indexOf(QByteArrayView haystack, QByteArrayView needle)
+{
+    if (needle.isEmpty()) {
+        return 0;
+    }
+
+    const char* begin = haystack.data();
+    const char* end = begin + haystack.size();
+    const char* p = begin;
+    while (end - p >= needle.size()) {
+        p = findByte(p, end - needle.size() + 1, needle.front());
+        if (end - p < needle.size()) {
+            break;
+        }
+        if (std::memcmp(p + 1, needle.data() + 1, size_t(needle.size() - 1)) == 0) {
+            return p - begin;
+        }
+        ++p;
+    }
+    return -1;
+}
+
+bool LineScanner::isValidUtf8(const char* begin, const char* end)
+{
+    const char* p = begin;
+    while (p < end) {
+        p = skipAscii(p, end);
+        if (p == end) {
+            break;
+        }
+
+        const unsigned char lead = static_cast<unsigned char>(*p);
+        int length = 0;
+        if (lead >= 0xC2 && lead <= 0xDF) {
+            length = 2;
+        } else if ((lead & 0xF0) == 0xE0) {
+            length = 3;
+        } else if (lead >= 0xF0 && lead <= 0xF4) {
+            length = 4;
+        } else {
+            return false;
+        }
+
+        if (end - p < length) {
+            return false;
+        }
+        const unsigned char second = static_cast<unsigned char>(p[1]);
+        if (!isContinuation(second)) {
+            return false;
+        }
+        // Отсекаем избыточные формы, суррогаты и значения больше U+10FFFF
+        if ((lead == 0xE0 && second < 0xA0) || (lead == 0xED && second > 0x9F)
+            || (lead == 0xF0 && second < 0x90) || (lead == 0xF4 && second > 0x8F)) {
+            return false;
+        }
+        for (int i = 2; i < length; ++i) {
+            if (!isContinuation(static_cast<unsigned char>(p[i]))) {
+                return false;
+            }
+        }
+        p += length;
+    }
+    return true;
+}
+
+const char* LineScanner::implementation()
+{
+#if defined(QUIZOWN_LINEPARSER_AVX2)
+    return "avx2";
+#elif defined(QUIZOWN_LINEPARSER_SSE2)
+    return "sse2";
+#else
+    return "scalar";
+#endif
+}
+
+LineReader::LineReader(QIODevice* device, qsizetype chunkSize)
+    : m_device(device)
+    , m_chunkSize(chunkSize)
+{
+}
+
+bool LineReader::next(QByteArrayView& line)
+{
+    for (;;) {
+        const char* data = m_buffer.constData();
+        const char* begin = data + m_position;
+        const char* end = data + m_end;
+        const char* newline = LineScanner::findByte(begin, end, '\n');
+
+        if (newline == end && !m_atEnd) {
+            if (!refill()) {
+                m_atEnd = true;
+            }
+            continue;
+        }
+        if (begin == end) {
+            return false;
+        }
+
+        m_position = newline == end ? m_end : (newline - data) + 1;
+        ++m_lineNumber;
+
+        // Пробелы обрезаются как в QString::trimmed(), включая неразрывные и прочие пробелы Unicode
+        const unsigned char* first = reinterpret_cast<const unsigned char*>(begin);
+        const unsigned char* last = reinterpret_cast<const unsigned char*>(newline);
+        while (int length = spaceLength(first, last)) {
+            first += length;
+        }
+        while (int length = trailingSpaceLength(first, last)) {
+            last -= length;
+        }
+        begin = reinterpret_cast<const char*>(first);
+        if (first == last) {
+            continue;
+        }
+
+        line = QByteArrayView(begin, last - first);
+        return true;
+    }
+}
+
+bool LineReader::refill()
+{
+    // Переносим недочитанный хвост в начало буфера; длинные строки увеличивают буфер
+    const qsizetype tail = m_end - m_position;
+    if (m_position > 0) {
+        std::memmove(m_buffer.data(), m_buffer.constData() + m_position, size_t(tail));
+        m_validated = qMax<qsizetype>(0, m_validated - m_position);
+        m_position = 0;
+        m_end = tail;
+    }
+    if (m_buffer.size() < m_end + m_chunkSize) {
+        m_buffer.resize(m_end + m_chunkSize);
+    }
+
+    const qint64 read = m_device->read(m_buffer.data() + m_end, m_chunkSize);
+    if (read < 0) {
+        m_error = true;
+        m_position = m_end = 0;
+        return false;
+    }
+    if (read == 0) {
+        validate(m_end);
+        return false;
+    }
+    m_end += qsizetype(read);
+    m_bytesRead += read;
+
+    // Проверяем UTF-8 только до последнего перевода строки, чтобы не разрезать символ
+    const char* data = m_buffer.constData();
+    qsizetype lastNewline = m_end;
+    while (lastNewline > m_validated && data[lastNewline - 1] != '\n') {
+        --lastNewline;
+    }
+    validate(lastNewline);
+    return true;
+}
+
+void LineReader::validate(qsizetype upTo)
+{
+    if (upTo <= m_validated) {
+        return;
+    }
+    const char* data = m_buffer.constData();
+    if (!LineScanner::isValidUtf8(data + m_validated, data + upTo)) {
+        m_invalidUtf8 = true;
+    }
+    m_validated = upTo;
+}
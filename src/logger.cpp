@@ -1,6 +1,107 @@
 #include "logger.h"
-#include <QTextStream>
+#include <QDeadlineTimer>
 #include <QDir>
+#include <QElapsedTimer>
+#include <QThread>
+#include <atomic>
+#include <cstdio>
+
+namespace {
+
+// Ёмкость кольцевого буфера записей (степень двойки)
+constexpr int kQueueCapacity = 8192;
+// Сколько записей фоновый поток пишет за один проход
+constexpr int kMaxBatch = 1024;
+// Как часто сбрасывать файл, если нет предупреждений и ошибок
+constexpr int kFlushIntervalMs = 200;
+// Сколько предупреждение или ошибка ждут места в переполненном буфере
+constexpr int kBackpressureMs = 100;
+
+} // namespace
+
+// Запись хранит сырые значения: текст и поля собираются в строку фоновым потоком
+struct Logger::Record {
+    qint64 timestamp = 0;
+    LogLevel level = LogLevel::Info;
+    const char* literal = nullptr;
+    QString message;
+    int fieldCount = 0;
+    LogField fields[MaxFields];
+};
+
+// Ограниченная очередь многих писателей и одного читателя на кольцевом буфере:
+// каждая ячейка хранит номер позиции, которую можно в неё записать или из неё прочитать,
+// поэтому писатели занимают позиции одной атомарной операцией и не берут блокировок.
+class Logger::RecordQueue
+{
+public:
+    explicit RecordQueue(int capacity)
+        : m_slots(new Slot[capacity])
+        , m_mask(quint64(capacity - 1))
+    {
+        for (int i = 0; i < capacity; ++i) {
+            m_slots[i].sequence.storeRelaxed(quint64(i));
+        }
+    }
+
+    bool tryPush(Record&& record)
+    {
+        quint64 position = m_enqueuePosition.loadRelaxed();
+        Slot* slot;
+        forever {
+            slot = &m_slots[position & m_mask];
+            const qint64 difference = qint64(slot->sequence.loadAcquire() - position);
+            if (difference == 0) {
+                if (m_enqueuePosition.testAndSetRelaxed(position, position + 1, position)) {
+                    break;
+                }
+            } else if (difference < 0) {
+                return false;   // буфер полон
+            } else {
+                position = m_enqueuePosition.loadRelaxed();
+            }
+        }
+        slot->record = std::move(record);
+        slot->sequence.storeRelease(position + 1);
+        return true;
+    }
+
+    // Вызывается только фоновым потоком
+    bool tryPop(Record& record)
+    {
+        Slot& slot = m_slots[m_dequeuePosition & m_mask];
+        if (slot.sequence.loadAcquire() != m_dequeuePosition + 1) {
+            return false;
+        }
+        record = std::move(slot.record);
+        slot.record.message = QString();
+        for (int i = 0; i < record.fieldCount; ++i) {
+            slot.record.fields[i].value = QVariant();
+        }
+        slot.sequence.storeRelease(m_dequeuePosition + m_mask + 1);
+        ++m_dequeuePosition;
+        return true;
+    }
+
+    bool isEmpty() const
+    {
+        return m_slots[m_dequeuePosition & m_mask].sequence.loadAcquire() != m_dequeuePosition + 1;
+    }
+
+    // Число занятых позиций; записи до этой позиции будут прочитаны по порядку
+    quint64 enqueued() const { return m_enqueuePosition.loadAcquire(); }
+
+private:
+    struct Slot {
+        QAtomicInteger<quint64> sequence;
+        Record record;
+    };
+
+    std::unique_ptr<Slot[]> m_slots;
+    const quint64 m_mask;
+    alignas(64) QAtomicInteger<quint64> m_enqueuePosition;
+    alignas(64) quint64 m_dequeuePosition = 0;
+};
 
 Logger& Logger::getInstance()
 {
@@ -9,15 +110,21 @@ Logger& Logger::getInstance()
 }
 
 Logger::Logger()
-    : m_logLevel(LogLevel::Info)
+    : m_logLevel(int(LogLevel::Info))
+    , m_queue(new RecordQueue(kQueueCapacity))
 {
     QString logPath = QDir::currentPath() + "/quiz.log";
     m_logFile.setFileName(logPath);
     m_logFile.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text);
+
+    m_writer = QThread::create([this]() { writerLoop(); });
+    m_writer->setObjectName("Logger");
+    m_writer->start();
 }
 
 Logger::~Logger()
 {
+    shutdown();
     if (m_logFile.isOpen()) {
         m_logFile.close();
     }
@@ -25,27 +132,231 @@ Logger::~Logger()
 
 void Logger::setLogLevel(LogLevel level)
 {
-    m_logLevel = level;
+    m_logLevel.storeRelaxed(int(level));
 }
 
 void Logger::log(LogLevel level, const QString& message)
 {
-    if (level < m_logLevel) return;
+    if (int(level) < m_logLevel.loadRelaxed()) return;
+
+    Record record;
+    record.timestamp = QDateTime::currentMSecsSinceEpoch();
+    record.level = level;
+    record.message = message;
+    enqueue(record);
+}
+
+void Logger::logFields(LogLevel level, const char* message, std::initializer_list<LogField> fields)
+{
+    if (int(level) < m_logLevel.loadRelaxed()) return;
+
+    Record record;
+    record.timestamp = QDateTime::currentMSecsSinceEpoch();
+    record.level = level;
+    record.literal = message;
+    for (const LogField& field : fields) {
+        if (record.fieldCount == MaxFields) {
+            break;
+        }
+        record.fields[record.fieldCount++] = field;
+    }
+    enqueue(record);
+}
+
+void Logger::enqueue(Record& record)
+{
+    // Счётчик писателей не даёт shutdown() остановить поток, пока запись не положена в буфер.
+    // Запись счётчика и чтение флага разделены полным барьером, парным барьеру в shutdown():
+    // иначе обе стороны могут увидеть старые значения и запись потеряется после остановки потока
+    m_producers.ref();
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!m_stopping.loadRelaxed()) {
+        bool pushed = m_queue->tryPush(std::move(record));
+        if (!pushed && record.level >= LogLevel::Warning) {
+            QElapsedTimer waited;
+            waited.start();
+            while (!pushed && waited.elapsed() < kBackpressureMs) {
+                wakeWriter();
+                QThread::yieldCurrentThread();
+                pushed = m_queue->tryPush(std::move(record));
+            }
+        }
+        if (!pushed) {
+            m_dropped.fetchAndAddRelaxed(1);
+        }
+        m_producers.deref();
+
+        // Будим фоновый поток, только если он заснул; парный барьер стоит в writerLoop()
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (m_writerSleeping.loadRelaxed()) {
+            wakeWriter();
+        }
+        return;
+    }
+    m_producers.deref();
+
+    // Фоновый поток уже остановлен: пишем синхронно
+    QMutexLocker locker(&m_mutex);
+    QByteArray line;
+    appendRecord(line, record);
+    writeBatch(line);
+    if (m_logFile.isOpen()) m_logFile.flush();
+}
+
+void Logger::flush()
+{
+    if (!m_writer || m_stopping.loadAcquire()) {
+        QMutexLocker locker(&m_mutex);
+        m_logFile.flush();
+        return;
+    }
 
-    if (!m_logFile.isOpen()) return;
+    const quint64 target = m_queue->enqueued();
+    QMutexLocker locker(&m_mutex);
+    while (m_flushedCount.loadAcquire() < target) {
+        m_flushRequested.storeRelease(1);
+        m_wakeWriter.wakeOne();
+        m_written.wait(&m_mutex, kFlushIntervalMs);
+    }
+}
 
-    QString timestamp = QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss.zzz");
-    QString logMessage = QString("[%1] [%2] %3\n")
-                            .arg(timestamp)
-                            .arg(levelToString(level))
-                            .arg(message);
+void Logger::shutdown()
+{
+    if (!m_writer) return;
 
-    QTextStream stream(&m_logFile);
-    stream << logMessage;
-    stream.flush();
+    m_stopping.storeRelaxed(1);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    while (m_producers.loadAcquire() != 0) {
+        QThread::yieldCurrentThread();
+    }
+    wakeWriter();
+    m_writer->wait();
+    delete m_writer;
+    m_writer = nullptr;
+}
 
-    // Также выводим в консоль
-    qDebug().noquote() << logMessage;
+void Logger::wakeWriter()
+{
+    QMutexLocker locker(&m_mutex);
+    m_wakeWriter.wakeOne();
+}
+
+void Logger::writerLoop()
+{
+    QByteArray batch;
+    batch.reserve(64 * 1024);
+    QElapsedTimer sinceFlush;
+    sinceFlush.start();
+    quint64 written = 0;
+    bool unflushed = false;
+
+    forever {
+        Record record;
+        int count = 0;
+        bool urgent = false;
+        while (count < kMaxBatch && m_queue->tryPop(record)) {
+            appendRecord(batch, record);
+            urgent = urgent || record.level >= LogLevel::Warning;
+            ++count;
+        }
+        const quint64 dropped = m_dropped.fetchAndStoreRelaxed(0);
+        if (dropped > 0) {
+            Record overflow;
+            overflow.timestamp = QDateTime::currentMSecsSinceEpoch();
+            overflow.level = LogLevel::Warning;
+            overflow.message = QString("Log queue overflow: %1 records dropped").arg(dropped);
+            appendRecord(batch, overflow);
+            urgent = true;
+        }
+        if (!batch.isEmpty()) {
+            writeBatch(batch);
+            batch.clear();
+            unflushed = true;
+        }
+        written += quint64(count);
+
+        const bool stopping = m_stopping.loadAcquire();
+        const bool drained = count < kMaxBatch;
+        // Ошибки сбрасываются сразу, остальное - не чаще раза в kFlushIntervalMs
+        if (unflushed && (urgent || stopping || m_flushRequested.loadAcquire()
+                          || sinceFlush.elapsed() >= kFlushIntervalMs)) {
+            m_logFile.flush();
+            unflushed = false;
+            sinceFlush.restart();
+        }
+        if (!unflushed && m_flushedCount.loadRelaxed() != written) {
+            QMutexLocker locker(&m_mutex);
+            m_flushedCount.storeRelease(written);
+            m_flushRequested.storeRelaxed(0);
+            m_written.wakeAll();
+        }
+        if (!drained) {
+            continue;
+        }
+        if (stopping && m_queue->isEmpty()) {
+            break;
+        }
+
+        QMutexLocker locker(&m_mutex);
+        m_writerSleeping.storeRelaxed(1);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (m_queue->isEmpty() && !m_stopping.loadAcquire() && !m_flushRequested.loadAcquire()) {
+            const qint64 timeout = unflushed ? qMax<qint64>(1, kFlushIntervalMs - sinceFlush.elapsed()) : -1;
+            m_wakeWriter.wait(&m_mutex, timeout < 0 ? QDeadlineTimer(QDeadlineTimer::Forever)
+                                                    : QDeadlineTimer(timeout));
+        }
+        m_writerSleeping.storeRelaxed(0);
+    }
+}
+
+void Logger::appendRecord(QByteArray& batch, const Record& record)
+{
+    // Префикс даты с точностью до секунды пересчитывается не чаще раза в секунду
+    const qint64 second = record.timestamp / 1000;
+    if (second != m_cachedSecond) {
+        m_cachedSecond = second;
+        m_cachedTimestamp = QDateTime::fromSecsSinceEpoch(second).toString("yyyy-MM-dd hh:mm:ss").toUtf8();
+    }
+    const int milliseconds = int(record.timestamp % 1000);
+    batch += '[';
+    batch += m_cachedTimestamp;
+    batch += '.';
+    batch += char('0' + milliseconds / 100);
+    batch += char('0' + milliseconds / 10 % 10);
+    batch += char('0' + milliseconds % 10);
+    batch += "] [";
+    batch += levelToString(record.level).toLatin1();
+    batch += "] ";
+    batch += record.literal ? QByteArray(record.literal) : record.message.toUtf8();
+    for (int i = 0; i < record.fieldCount; ++i) {
+        // key=value, значения с пробелами в кавычках
+        const QVariant& field = record.fields[i].value;
+        const QByteArray value = (field.userType() == QMetaType::QStringList ? field.toStringList().join(',')
+                                                                              : field.toString()).toUtf8();
+        batch += ' ';
+        batch += record.fields[i].key;
+        batch += '=';
+        if (value.isEmpty() || value.contains(' ') || value.contains('"')) {
+            batch += '"';
+            batch += QByteArray(value).replace('"', "\\\"");
+            batch += '"';
+        } else {
+            batch += value;
+        }
+    }
+    batch += '\n';
+}
+
+void Logger::writeBatch(const QByteArray& batch)
+{
+    if (m_logFile.isOpen()) {
+        m_logFile.write(batch);
+    }
+    // В консоль идут те же готовые байты пакета, без повторного форматирования записей
+    if (m_consoleOutput.loadRelaxed()) {
+        std::fwrite(batch.constData(), 1, size_t(batch.size()), stderr);
+        std::fflush(stderr);
+    }
 }
 
 QString Logger::levelToString(LogLevel level)
@@ -62,4 +373,4 @@ QString Logger::levelToString(LogLevel level)
         default:
             return "UNKNOWN";
     }
-} 
\ No newline at end of file
+}
@@ -1,13 +1,100 @@
 #include "mainwindow.h"
+#include "quizmanager.h"
+#include "quizserver.h"
 #include "logger.h"
+#include "metrics.h"
 #include <QApplication>
+#include <QCommandLineParser>
+#include <QHostAddress>
 #include <QStyle>
 #include <QStyleFactory>
 #include <QFile>
 #include <QTextStream>
+#include <QTimer>
+
+namespace {
+
+void setApplicationInfo()
+{
+    QCoreApplication::setApplicationName("QuizOwn");
+    QCoreApplication::setApplicationVersion("1.0.0");
+    QCoreApplication::setOrganizationName("QuizOwn");
+    QCoreApplication::setOrganizationDomain("quizown.com");
+}
+
+const QCommandLineOption kMetricsOption("metrics", "Periodically write latency metrics to <file> "
+                                        "(.json for JSON, otherwise Prometheus text format)", "file");
+const QCommandLineOption kMetricsIntervalOption("metrics-interval", "Metrics write interval in seconds (default: 10)",
+                                                "seconds", "10");
+const QCommandLineOption kLogConsoleOption("log-console", "Also echo log records to stderr");
+
+// Периодическая выгрузка метрик (--metrics); последний снимок пишется при выходе
+void startMetricsDump(const QCommandLineParser& parser, QCoreApplication& app)
+{
+    const QString filePath = parser.value(kMetricsOption);
+    if (filePath.isEmpty()) {
+        return;
+    }
+    auto write = [filePath]() { Metrics::instance().writeToFile(filePath); };
+    QTimer *timer = new QTimer(&app);
+    timer->setInterval(qMax(1, parser.value(kMetricsIntervalOption).toInt()) * 1000);
+    QObject::connect(timer, &QTimer::timeout, &app, write);
+    QObject::connect(&app, &QCoreApplication::aboutToQuit, &app, write);
+    timer->start();
+    LOG_INFO("Writing metrics to " + filePath);
+}
+
+// Режим сервера: без окон, кандидаты проходят тесты из браузера по HTTP/WebSocket
+int runServer(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    setApplicationInfo();
+    Logger::getInstance();
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("QuizOwn quiz server");
+    parser.addHelpOption();
+    parser.addVersionOption();
+    QCommandLineOption serveOption("serve", "Run the HTTP/WebSocket quiz server instead of the GUI");
+    QCommandLineOption portOption("port", "Port to listen on (default: 8080)", "port", "8080");
+    QCommandLineOption bindOption("bind", "Address to bind (default: all interfaces)", "address", "0.0.0.0");
+    QCommandLineOption threadsOption("threads", "Worker threads (default: number of cores)", "count", "0");
+    QCommandLineOption maxSessionsOption("max-sessions", "Maximum active sessions, 0 for no limit (default: 10000)",
+                                         "count", "10000");
+    QCommandLineOption sessionTimeoutOption("session-timeout",
+                                            "End sessions idle for this many seconds, 0 to keep them (default: 1800)",
+                                            "seconds", "1800");
+    QCommandLineOption serveMetricsOption("serve-metrics", "Expose latency metrics at GET /metrics");
+    parser.addOptions({ serveOption, portOption, bindOption, threadsOption, maxSessionsOption, sessionTimeoutOption,
+                        serveMetricsOption, kMetricsOption, kMetricsIntervalOption, kLogConsoleOption });
+    parser.process(app);
+    Logger::getInstance().setConsoleOutput(parser.isSet(kLogConsoleOption));
+    startMetricsDump(parser, app);
+
+    QuizManager manager;
+    QuizServer server(&manager);
+    server.setSessionLimits(parser.value(maxSessionsOption).toInt(), parser.value(sessionTimeoutOption).toInt());
+    server.setMetricsEnabled(parser.isSet(serveMetricsOption));
+    if (!server.start(QHostAddress(parser.value(bindOption)), quint16(parser.value(portOption).toUInt()),
+                      parser.value(threadsOption).toInt())) {
+        return 1;
+    }
+    const int result = app.exec();
+    Logger::getInstance().shutdown();
+    return result;
+}
+
+} // namespace
 
 int main(int argc, char *argv[])
 {
+    // Режим выбирается до создания приложения: серверу не нужен QApplication
+    for (int i = 1; i < argc; ++i) {
+        if (qstrcmp(argv[i], "--serve") == 0) {
+            return runServer(argc, argv);
+        }
+    }
+
     QApplication a(argc, argv);
     
     // Инициализируем логгер
@@ -28,15 +115,24 @@ int main(int argc, char *argv[])
     }
     
     // Устанавливаем информацию о приложении
-    QApplication::setApplicationName("QuizOwn");
-    QApplication::setApplicationVersion("1.0.0");
-    QApplication::setOrganizationName("QuizOwn");
-    QApplication::setOrganizationDomain("quizown.com");
+    setApplicationInfo();
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("QuizOwn");
+    parser.addHelpOption();
+    parser.addVersionOption();
+    parser.addOptions({ kMetricsOption, kMetricsIntervalOption, kLogConsoleOption });
+    parser.process(a);
+    Logger::getInstance().setConsoleOutput(parser.isSet(kLogConsoleOption));
+    startMetricsDump(parser, a);
     
     MainWindow w;
     w.show();
     
     LOG_INFO("Application started");
     
-    return a.exec();
+    const int result = a.exec();
+    // Дописываем журнал, пока приложение ещё живо
+    Logger::getInstance().shutdown();
+    return result;
 } 
\ No newline at end of file
@@ -10,10 +10,14 @@
 #include <QGroupBox>
 #include <QApplication>
 #include <QButtonGroup>
-#include <QListWidget>
-#include <QListWidgetItem>
+#include <QListView>
+#include <QItemSelectionModel>
 #include <QRadioButton>
+#include "answerstate.h"
 #include "logger.h"
+#include "metrics.h"
+#include "diagnosticsdialog.h"
+#include "sectionlistmodel.h"
 #include <QIcon>
 #include <QTimer>
 
@@ -21,7 +25,7 @@ MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
     , m_quizManager(new QuizManager(this))
     , m_sectionDialog(new SectionDialog(this))
-    , m_sectionButtonGroup(new QButtonGroup(this))
+    , m_sectionsModel(new SectionListModel(m_quizManager, this))
     , m_answerButtonGroup(new QButtonGroup(this))
 {
     setWindowTitle(tr("Quiz Own"));
@@ -53,11 +57,18 @@ MainWindow::MainWindow(QWidget *parent)
     // Sections label
     QLabel *sectionsLabel = new QLabel(tr("Разделы:"), this);
 
-    // Sections container
-    m_sectionsContainer = new QWidget(this);
-    m_sectionsLayout = new QVBoxLayout(m_sectionsContainer);
-    m_sectionsLayout->setSpacing(5);
-    m_sectionsLayout->setContentsMargins(0, 0, 0, 0);
+    // Sections filter and list
+    m_sectionFilterEdit = new QLineEdit(this);
+    m_sectionFilterEdit->setPlaceholderText(tr("Поиск раздела"));
+    m_sectionFilterEdit->setClearButtonEnabled(true);
+
+    // Строки одинаковой высоты: вид не измеряет каждую и рисует только видимые
+    m_sectionsView = new QListView(this);
+    m_sectionsView->setObjectName("sectionList");
+    m_sectionsView->setModel(m_sectionsModel);
+    m_sectionsView->setUniformItemSizes(true);
+    m_sectionsView->setSelectionMode(QAbstractItemView::SingleSelection);
+    m_sectionsView->setEditTriggers(QAbstractItemView::NoEditTriggers);
 
     // Section management buttons
     QHBoxLayout *sectionButtonsLayout = new QHBoxLayout;
@@ -81,10 +92,10 @@ MainWindow::MainWindow(QWidget *parent)
 
     // Add widgets to left panel
     leftPanelLayout->addWidget(sectionsLabel);
-    leftPanelLayout->addWidget(m_sectionsContainer);
+    leftPanelLayout->addWidget(m_sectionFilterEdit);
+    leftPanelLayout->addWidget(m_sectionsView, 1);
     leftPanelLayout->addLayout(sectionButtonsLayout);
     leftPanelLayout->addWidget(m_startMarathonButton);
-    leftPanelLayout->addStretch();
 
     // Create right panel (stacked widget)
     m_stackedWidget = new QStackedWidget(this);
@@ -112,7 +123,13 @@ MainWindow::MainWindow(QWidget *parent)
     QWidget *answersContainer = new QWidget(this);
     m_answersLayout = new QVBoxLayout(answersContainer);
     m_answersLayout->setSpacing(10);
-    
+
+    // Метка правильного ответа создаётся один раз и стоит после кнопок ответов
+    m_correctAnswerLabel = new QLabel(this);
+    m_correctAnswerLabel->setObjectName("correctAnswerLabel");
+    m_correctAnswerLabel->hide();
+    m_answersLayout->addWidget(m_correctAnswerLabel);
+
     m_submitButton = new QPushButton(tr("Ответить"), this);
     m_submitButton->setIcon(QIcon(":/icons/submit.png"));
     m_nextButton = new QPushButton(tr("Следующий"), this);
@@ -152,6 +169,8 @@ MainWindow::MainWindow(QWidget *parent)
     connect(exitAction, &QAction::triggered, this, &QWidget::close);
 
     QMenu *helpMenu = menuBar->addMenu(tr("Справка"));
+    QAction *diagnosticsAction = helpMenu->addAction(tr("Диагностика"));
+    connect(diagnosticsAction, &QAction::triggered, this, &MainWindow::onDiagnostics);
     QAction *aboutAction = helpMenu->addAction(tr("О программе"));
     connect(aboutAction, &QAction::triggered, this, &MainWindow::onAbout);
 
@@ -176,8 +195,10 @@ void MainWindow::setupConnections()
     connect(m_addSectionButton, &QPushButton::clicked, this, &MainWindow::onAddSection);
     connect(m_editSectionButton, &QPushButton::clicked, this, &MainWindow::onEditSection);
     connect(m_removeSectionButton, &QPushButton::clicked, this, &MainWindow::onRemoveSection);
-    connect(m_sectionButtonGroup, QOverload<QAbstractButton*>::of(&QButtonGroup::buttonClicked),
+    connect(m_sectionsView->selectionModel(), &QItemSelectionModel::selectionChanged,
             this, &MainWindow::onSectionSelected);
+    connect(m_sectionsModel, &QAbstractItemModel::modelReset, this, &MainWindow::onSectionSelected);
+    connect(m_sectionFilterEdit, &QLineEdit::textChanged, this, &MainWindow::onSectionFilterChanged);
     connect(m_startMarathonButton, &QPushButton::clicked, this, &MainWindow::onStartMarathon);
 
     // Marathon
@@ -188,20 +209,33 @@ void MainWindow::setupConnections()
     // QuizManager signals
     connect(m_quizManager, &QuizManager::marathonStarted, this, [this]() {
         LOG_INFO("Marathon started");
+        // Первый вопрос приходит следом в questionChanged
         m_stackedWidget->setCurrentIndex(1);
-        updateUI();
     });
 
     connect(m_quizManager, &QuizManager::marathonEnded, this, [this](int correct, int total) {
         LOG_INFO("Marathon ended, correct: " + QString::number(correct) + ", total: " + QString::number(total));
-        showInfo(tr("Марафон завершен!\nПравильных ответов: %1 из %2").arg(correct).arg(total));
+        const AnswerStatuses::Counts counts = m_quizManager->getMarathonCounts();
+        QString message = tr("Марафон завершен!\nПравильных ответов: %1 из %2\nОшибок: %3, без ответа: %4")
+                              .arg(correct).arg(total).arg(counts.wrong).arg(counts.unanswered);
+
+        // Разбивка по разделам - для небольших марафонов, чтобы окно оставалось читаемым
+        const QVector<QuizManager::SectionScore> scores = m_quizManager->getMarathonSectionScores();
+        if (scores.size() > 1 && scores.size() <= 10) {
+            message += '\n';
+            for (const QuizManager::SectionScore &score : scores) {
+                message += '\n' + tr("%1: %2 из %3").arg(score.section).arg(score.counts.correct)
+                                                     .arg(score.counts.total());
+            }
+        }
+        showInfo(message);
         m_stackedWidget->setCurrentIndex(0);
-        updateUI();
     });
 
+    // Смена вопроса не трогает список разделов
     connect(m_quizManager, &QuizManager::questionChanged, this, [this](int index) {
         LOG_INFO("Question changed to index: " + QString::number(index));
-        updateUI();
+        updateQuestionView();
     });
 
     connect(m_quizManager, &QuizManager::answerChecked, this, [this](bool correct) {
@@ -210,17 +244,22 @@ void MainWindow::setupConnections()
 
     connect(m_quizManager, &QuizManager::sectionAdded, this, [this](const QString &name) {
         LOG_INFO("Section added: " + name);
-        updateUI();
+        updateSectionActions();
     });
 
     connect(m_quizManager, &QuizManager::sectionRemoved, this, [this](const QString &name) {
         LOG_INFO("Section removed: " + name);
-        updateUI();
+        updateSectionActions();
     });
 
     connect(m_quizManager, &QuizManager::sectionEdited, this, [this](const QString &name) {
         LOG_INFO("Section edited: " + name);
-        updateUI();
+        updateSectionActions();
+    });
+
+    connect(m_quizManager, &QuizManager::sectionReloaded, this, [this](const QString &name) {
+        LOG_INFO("Section reloaded: " + name);
+        statusBar()->showMessage(tr("Раздел \"%1\" обновлён").arg(name), 5000);
     });
 
     connect(m_quizManager, &QuizManager::error, this, &MainWindow::showError);
@@ -228,86 +267,102 @@ void MainWindow::setupConnections()
 
 void MainWindow::updateUI()
 {
-    LOG_INFO("Starting updateUI");
-    
-    // Обновляем список разделов
-    QLayoutItem *child;
-    while ((child = m_sectionsLayout->takeAt(0)) != nullptr) {
-        if (child->widget()) {
-            child->widget()->deleteLater();
-        }
-        delete child;
+    METRICS_SCOPED_TIMER("quizown_ui_update_seconds", "Refreshing the main window");
+
+    updateSectionActions();
+    updateQuestionView();
+}
+
+void MainWindow::updateSectionActions()
+{
+    // Строки списка модель обновляет сама по сигналам QuizManager
+    m_startMarathonButton->setEnabled(m_quizManager->sectionCount() > 0);
+    onSectionSelected();
+}
+
+QString MainWindow::selectedSectionName() const
+{
+    const QModelIndexList selected = m_sectionsView->selectionModel()->selectedIndexes();
+    return selected.isEmpty() ? QString() : m_sectionsModel->sectionName(selected.first().row());
+}
+
+void MainWindow::selectSection(const QString &name)
+{
+    const int row = m_sectionsModel->rowOf(name);
+    if (row < 0) {
+        return;
     }
-    
-    QStringList sections = m_quizManager->getSectionNames();
-    LOG_INFO("Sections count: " + QString::number(sections.size()));
-    
-    for (const QString &section : sections) {
-        QPushButton *button = new QPushButton(section, this);
-        button->setObjectName("sectionButton");
-        button->setCheckable(true);
-        m_sectionButtonGroup->addButton(button);
-        m_sectionsLayout->addWidget(button);
+    const QModelIndex index = m_sectionsModel->index(row);
+    m_sectionsView->setCurrentIndex(index);
+    m_sectionsView->scrollTo(index);
+}
+
+void MainWindow::onSectionFilterChanged(const QString &text)
+{
+    // Фильтр сбрасывает модель, поэтому выбранный раздел восстанавливается по имени
+    const QString selected = selectedSectionName();
+    m_sectionsModel->setFilter(text);
+    selectSection(selected);
+}
+
+void MainWindow::updateQuestionView()
+{
+    METRICS_SCOPED_TIMER("quizown_ui_question_update_seconds", "Refreshing the marathon question");
+
+    if (!m_quizManager->isMarathonActive()) {
+        LOG_INFO_KV("Marathon is not active");
+        return;
     }
-    
-    // Обновляем состояние кнопок разделов
-    m_editSectionButton->setEnabled(!sections.isEmpty());
-    m_removeSectionButton->setEnabled(!sections.isEmpty());
-    
-    // Обновляем состояние кнопки марафона
-    m_startMarathonButton->setEnabled(!sections.isEmpty());
-    
-    if (m_quizManager->isMarathonActive()) {
-        LOG_INFO("Marathon is active, updating marathon UI");
-        QString question = m_quizManager->getCurrentMarathonQuestion();
-        LOG_INFO("Current marathon question: " + question);
-        
-        if (question.isEmpty()) {
-            LOG_ERROR("Empty marathon question received");
-            return;
-        }
-        
-        m_questionLabel->setText(question);
-        LOG_INFO("Question label updated");
-        
-        // Clear existing answer buttons
-        QLayoutItem *answerChild;
-        while ((answerChild = m_answersLayout->takeAt(0)) != nullptr) {
-            if (answerChild->widget()) {
-                answerChild->widget()->deleteLater();
+
+    const QString question = m_quizManager->getCurrentMarathonQuestion();
+    LOG_INFO_KV("Current marathon question", { { "text", question } });
+    if (question.isEmpty()) {
+        LOG_ERROR("Empty marathon question received");
+        return;
+    }
+    m_questionLabel->setText(question);
+
+    const QStringList answers = m_quizManager->getCurrentMarathonAnswers();
+    LOG_INFO_KV("Marathon answers", { { "count", int(answers.size()) } });
+
+    // Снимаем выбор предыдущего ответа; у эксклюзивной группы это делается только так
+    if (QAbstractButton *checked = m_answerButtonGroup->checkedButton()) {
+        m_answerButtonGroup->setExclusive(false);
+        checked->setChecked(false);
+        m_answerButtonGroup->setExclusive(true);
+    }
+
+    // Кнопки ответов переиспользуются: меняется только то, что отличается от прошлого вопроса
+    for (int i = 0; i < answers.size(); ++i) {
+        QRadioButton *button = nullptr;
+        if (i < m_answerButtons.size()) {
+            button = m_answerButtons[i];
+            if (button->text() != answers[i]) {
+                button->setText(answers[i]);
             }
-            delete answerChild;
-        }
-        LOG_INFO("Cleared existing answer buttons");
-
-        // Create new answer buttons
-        QStringList answers = m_quizManager->getCurrentMarathonAnswers();
-        LOG_INFO("Marathon answers count: " + QString::number(answers.size()));
-        for (const QString &answer : answers) {
-            QRadioButton *button = new QRadioButton(answer, this);
-            button->setEnabled(true); // Включаем кнопку
-            button->setStyleSheet(""); // Сбрасываем стиль
+        } else {
+            button = new QRadioButton(answers[i], this);
             m_answerButtonGroup->addButton(button);
-            m_answersLayout->addWidget(button);
+            m_answersLayout->insertWidget(i, button);
+            m_answerButtons.append(button);
         }
-        LOG_INFO("Created new marathon answer buttons");
-        
-        m_progressLabel->setText(tr("Вопрос %1 из %2")
-                               .arg(m_quizManager->getCurrentMarathonQuestionIndex() + 1)
-                               .arg(m_quizManager->getTotalMarathonQuestions()));
-        LOG_INFO("Progress label updated");
-        
-        m_scoreLabel->setText(tr("Правильных ответов: %1")
-                            .arg(m_quizManager->getMarathonCorrectAnswers()));
-        LOG_INFO("Score label updated");
-
-        // Включаем кнопку отправки ответа
-        m_submitButton->setEnabled(true);
-    } else {
-        LOG_INFO("Marathon is not active");
+        button->setEnabled(true);
+        setAnswerState(button, QString());
+        button->show();
     }
-    
-    LOG_INFO("updateUI completed");
+    for (int i = answers.size(); i < m_answerButtons.size(); ++i) {
+        m_answerButtons[i]->hide();
+    }
+    m_correctAnswerLabel->hide();
+
+    m_progressLabel->setText(tr("Вопрос %1 из %2")
+                           .arg(m_quizManager->getCurrentMarathonQuestionIndex() + 1)
+                           .arg(m_quizManager->getTotalMarathonQuestions()));
+    m_scoreLabel->setText(tr("Правильных ответов: %1")
+                        .arg(m_quizManager->getMarathonCorrectAnswers()));
+
+    // Включаем кнопку отправки ответа
+    m_submitButton->setEnabled(true);
 }
 
 void MainWindow::showError(const QString &message)
@@ -332,19 +387,17 @@ void MainWindow::onAddSection()
 
         if (m_quizManager->addSection(name, questionsFile, answersFile)) {
             showInfo(tr("Раздел успешно добавлен"));
-            updateUI();
         }
     }
 }
 
 void MainWindow::onEditSection()
 {
-    QAbstractButton *button = m_sectionButtonGroup->checkedButton();
-    if (!button) {
+    const QString oldName = selectedSectionName();
+    if (oldName.isEmpty()) {
         return;
     }
 
-    QString oldName = button->text();
     m_sectionDialog->setWindowTitle(tr("Редактировать раздел"));
     m_sectionDialog->setSectionName(oldName);
     m_sectionDialog->setQuestionsFile(m_quizManager->getSectionQuestionsFile(oldName));
@@ -357,19 +410,18 @@ void MainWindow::onEditSection()
 
         if (m_quizManager->editSection(oldName, newName, questionsFile, answersFile)) {
             showInfo(tr("Раздел успешно отредактирован"));
-            updateUI();
+            selectSection(newName);
         }
     }
 }
 
 void MainWindow::onRemoveSection()
 {
-    QAbstractButton *button = m_sectionButtonGroup->checkedButton();
-    if (!button) {
+    const QString name = selectedSectionName();
+    if (name.isEmpty()) {
         return;
     }
 
-    QString name = button->text();
     QMessageBox::StandardButton reply = QMessageBox::question(
         this,
         tr("Подтверждение"),
@@ -380,45 +432,48 @@ void MainWindow::onRemoveSection()
     if (reply == QMessageBox::Yes) {
         if (m_quizManager->removeSection(name)) {
             showInfo(tr("Раздел успешно удален"));
-            updateUI();
         }
     }
 }
 
 void MainWindow::onSectionSelected()
 {
-    QAbstractButton *button = m_sectionButtonGroup->checkedButton();
-    if (button) {
-        m_editSectionButton->setEnabled(true);
-        m_removeSectionButton->setEnabled(true);
-    } else {
-        m_editSectionButton->setEnabled(false);
-        m_removeSectionButton->setEnabled(false);
-    }
+    const bool selected = m_sectionsView->selectionModel()->hasSelection();
+    m_editSectionButton->setEnabled(selected);
+    m_removeSectionButton->setEnabled(selected);
 }
 
 void MainWindow::onStartMarathon()
 {
-    QStringList sections = m_quizManager->getSectionNames();
-    if (sections.isEmpty()) {
+    if (m_quizManager->sectionCount() == 0) {
         showError(tr("Нет доступных разделов для марафона"));
         return;
     }
 
+    // Модель объявлена раньше диалога, чтобы пережить его список
+    SectionListModel model(m_quizManager);
+    model.setCheckable(true);
+
     QDialog dialog(this);
     dialog.setWindowTitle(tr("Выберите разделы для марафона"));
     dialog.setMinimumWidth(300);
 
     QVBoxLayout *layout = new QVBoxLayout(&dialog);
-    QListWidget *listWidget = new QListWidget(&dialog);
-    listWidget->setSelectionMode(QListWidget::MultiSelection);
-    
-    for (const QString &section : sections) {
-        QListWidgetItem *item = new QListWidgetItem(section);
-        item->setFlags(item->flags() | Qt::ItemIsUserCheckable);
-        item->setCheckState(Qt::CheckState::Checked);
-        listWidget->addItem(item);
-    }
+    QLineEdit *filterEdit = new QLineEdit(&dialog);
+    filterEdit->setPlaceholderText(tr("Поиск раздела"));
+    filterEdit->setClearButtonEnabled(true);
+    QListView *listView = new QListView(&dialog);
+    listView->setModel(&model);
+    listView->setUniformItemSizes(true);
+    listView->setSelectionMode(QAbstractItemView::NoSelection);
+    listView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+
+    // Отметка действует на разделы, видимые с текущим фильтром
+    QPushButton *checkAllButton = new QPushButton(tr("Отметить все"), &dialog);
+    QPushButton *uncheckAllButton = new QPushButton(tr("Снять все"), &dialog);
+    QHBoxLayout *checkLayout = new QHBoxLayout();
+    checkLayout->addWidget(checkAllButton);
+    checkLayout->addWidget(uncheckAllButton);
 
     QPushButton *okButton = new QPushButton(tr("Начать"), &dialog);
     QPushButton *cancelButton = new QPushButton(tr("Отмена"), &dialog);
@@ -427,57 +482,29 @@ void MainWindow::onStartMarathon()
     buttonLayout->addWidget(okButton);
     buttonLayout->addWidget(cancelButton);
 
-    layout->addWidget(listWidget);
+    layout->addWidget(filterEdit);
+    layout->addWidget(listView);
+    layout->addLayout(checkLayout);
     layout->addLayout(buttonLayout);
 
+    connect(filterEdit, &QLineEdit::textChanged, &model, &SectionListModel::setFilter);
+    connect(checkAllButton, &QPushButton::clicked, &model, [&model]() { model.setVisibleChecked(true); });
+    connect(uncheckAllButton, &QPushButton::clicked, &model, [&model]() { model.setVisibleChecked(false); });
     connect(okButton, &QPushButton::clicked, &dialog, &QDialog::accept);
     connect(cancelButton, &QPushButton::clicked, &dialog, &QDialog::reject);
 
     if (dialog.exec() == QDialog::Accepted) {
-        QStringList selectedSections;
-        for (int i = 0; i < listWidget->count(); ++i) {
-            QListWidgetItem *item = listWidget->item(i);
-            if (item->checkState() == Qt::CheckState::Checked) {
-                selectedSections.append(item->text());
-            }
-        }
+        const QStringList selectedSections = model.checkedSectionNames();
 
         if (selectedSections.isEmpty()) {
             showError(tr("Выберите хотя бы один раздел для марафона"));
             return;
         }
 
-        LOG_INFO("Starting marathon with sections: " + selectedSections.join(", "));
+        LOG_INFO_KV("Starting marathon", { { "sections", int(selectedSections.size()) } });
         if (m_quizManager->startMarathon(selectedSections)) {
+            // Вопрос и страницу марафона показывает обработчик marathonStarted
             LOG_INFO("Marathon started successfully");
-            
-            // Очищаем предыдущие ответы
-            QLayoutItem *child;
-            while ((child = m_answersLayout->takeAt(0)) != nullptr) {
-                if (child->widget()) {
-                    child->widget()->deleteLater();
-                }
-                delete child;
-            }
-            
-            // Создаем новые кнопки ответов
-            QStringList answers = m_quizManager->getCurrentMarathonAnswers();
-            for (const QString &answer : answers) {
-                QRadioButton *button = new QRadioButton(answer, this);
-                m_answerButtonGroup->addButton(button);
-                m_answersLayout->addWidget(button);
-            }
-            
-            // Обновляем вопрос и прогресс
-            m_questionLabel->setText(m_quizManager->getCurrentMarathonQuestion());
-            m_progressLabel->setText(tr("Вопрос %1 из %2")
-                                   .arg(m_quizManager->getCurrentMarathonQuestionIndex() + 1)
-                                   .arg(m_quizManager->getTotalMarathonQuestions()));
-            m_scoreLabel->setText(tr("Правильных ответов: %1")
-                                .arg(m_quizManager->getMarathonCorrectAnswers()));
-            
-            // Переключаемся на страницу марафона
-            m_stackedWidget->setCurrentIndex(1);
         } else {
             LOG_ERROR("Failed to start marathon");
             showError(tr("Не удалось начать марафон"));
@@ -487,6 +514,8 @@ void MainWindow::onStartMarathon()
 
 void MainWindow::onAnswerSubmitted()
 {
+    METRICS_SCOPED_TIMER("quizown_answer_submit_seconds", "Handling a submitted answer in the main window");
+
     if (!m_answerButtonGroup->checkedButton()) {
         showError(tr("Выберите ответ"));
         return;
@@ -494,31 +523,22 @@ void MainWindow::onAnswerSubmitted()
 
     QString answer = m_answerButtonGroup->checkedButton()->text();
     bool correct = m_quizManager->checkMarathonAnswer(answer);
+    const QString correctAnswer = m_quizManager->getCurrentMarathonAnswer();
 
-    // Отключаем все кнопки после ответа
+    // Отключаем все кнопки после ответа и подсвечиваем выбранный и правильный варианты
     for (QAbstractButton* button : m_answerButtonGroup->buttons()) {
         button->setEnabled(false);
-        QRadioButton* radioButton = qobject_cast<QRadioButton*>(button);
-        if (radioButton) {
-            if (radioButton->text() == answer) {
-                // Если это выбранный ответ
-                if (correct) {
-                    radioButton->setStyleSheet("QRadioButton { background-color: #4CAF50; color: white; }");
-                } else {
-                    radioButton->setStyleSheet("QRadioButton { background-color: #F44336; color: white; }");
-                }
-            } else if (radioButton->text() == m_quizManager->getCurrentMarathonAnswer()) {
-                // Если это правильный ответ
-                radioButton->setStyleSheet("QRadioButton { background-color: #4CAF50; color: white; }");
-            }
+        if (button->text() == answer) {
+            setAnswerState(button, correct ? "correct" : "wrong");
+        } else if (button->text() == correctAnswer) {
+            setAnswerState(button, "correct");
         }
     }
 
     // Добавляем метку с правильным ответом
     if (!correct) {
-        QLabel* correctAnswerLabel = new QLabel(tr("Правильный ответ: %1").arg(m_quizManager->getCurrentMarathonAnswer()), this);
-        correctAnswerLabel->setStyleSheet("QLabel { color: #4CAF50; font-weight: bold; }");
-        m_answersLayout->addWidget(correctAnswerLabel);
+        m_correctAnswerLabel->setText(tr("Правильный ответ: %1").arg(correctAnswer));
+        m_correctAnswerLabel->show();
     }
 
     // Отключаем кнопку отправки ответа
@@ -527,10 +547,10 @@ void MainWindow::onAnswerSubmitted()
     // Если ответ правильный, переходим к следующему вопросу через 1 секунду
     if (correct) {
         QTimer::singleShot(1000, this, [this]() {
+            // Новый вопрос показывает обработчик questionChanged
             if (!m_quizManager->nextMarathonQuestion()) {
                 m_stackedWidget->setCurrentIndex(0);
             }
-            updateUI();
         });
     }
 }
@@ -538,18 +558,14 @@ void MainWindow::onAnswerSubmitted()
 void MainWindow::onNextQuestion()
 {
     if (m_quizManager->isMarathonActive()) {
-        if (m_quizManager->nextMarathonQuestion()) {
-            updateUI();
-        }
+        m_quizManager->nextMarathonQuestion();
     }
 }
 
 void MainWindow::onPreviousQuestion()
 {
     if (m_quizManager->isMarathonActive()) {
-        if (m_quizManager->previousMarathonQuestion()) {
-            updateUI();
-        }
+        m_quizManager->previousMarathonQuestion();
     }
 }
 
@@ -567,91 +583,13 @@ void MainWindow::onSettings()
     showInfo(tr("Настройки пока не реализованы"));
 }
 
-void MainWindow::showResults()
-{
-    int correct = m_quizManager->getCorrectAnswers();
-    int total = m_quizManager->getTotalQuestions();
-    
-    QString message = tr("Тест завершен!\n\n"
-                        "Правильных ответов: %1 из %2\n"
-                        "Процент правильных ответов: %3%")
-                        .arg(correct)
-                        .arg(total)
-                        .arg((correct * 100.0) / total, 0, 'f', 1);
-    
-    QMessageBox::information(this, tr("Результаты теста"), message);
-    m_stackedWidget->setCurrentIndex(0);
-    updateUI();
-}
-
-void MainWindow::setupTestUI()
+void MainWindow::onDiagnostics()
 {
-    // Создаем виджет для теста
-    QWidget* testWidget = new QWidget(this);
-    QVBoxLayout* testLayout = new QVBoxLayout(testWidget);
-    
-    // Создаем метку для вопроса
-    m_questionLabel = new QLabel(this);
-    m_questionLabel->setWordWrap(true);
-    m_questionLabel->setAlignment(Qt::AlignCenter);
-    m_questionLabel->setStyleSheet("font-size: 16px; margin: 20px;");
-    testLayout->addWidget(m_questionLabel);
-    
-    // Создаем контейнер для кнопок ответов
-    m_answersContainer = new QWidget(this);
-    m_answersLayout = new QVBoxLayout(m_answersContainer);
-    m_answersLayout->setSpacing(10);
-    testLayout->addWidget(m_answersContainer);
-    
-    // Создаем виджет для навигации
-    QWidget* navigationWidget = new QWidget(this);
-    QHBoxLayout* navigationLayout = new QHBoxLayout(navigationWidget);
-    
-    // Кнопка предыдущего вопроса
-    m_prevButton = new QPushButton("←", this);
-    m_prevButton->setFixedSize(40, 40);
-    m_prevButton->setStyleSheet("QPushButton { background-color: #4CAF50; color: white; border: none; border-radius: 20px; } QPushButton:hover { background-color: #45a049; }");
-    navigationLayout->addWidget(m_prevButton);
-    
-    // Кнопка завершения теста
-    m_endTestButton = new QPushButton("Завершить тест", this);
-    m_endTestButton->setStyleSheet("QPushButton { background-color: #f44336; color: white; border: none; padding: 8px 16px; border-radius: 4px; } QPushButton:hover { background-color: #da190b; }");
-    navigationLayout->addWidget(m_endTestButton);
-    
-    // Кнопка следующего вопроса
-    m_nextButton = new QPushButton("→", this);
-    m_nextButton->setFixedSize(40, 40);
-    m_nextButton->setStyleSheet("QPushButton { background-color: #4CAF50; color: white; border: none; border-radius: 20px; } QPushButton:hover { background-color: #45a049; }");
-    navigationLayout->addWidget(m_nextButton);
-    
-    testLayout->addWidget(navigationWidget);
-    
-    // Добавляем виджет теста в стек
-    m_stackedWidget->addWidget(testWidget);
-    
-    // Подключаем сигналы
-    connect(m_prevButton, &QPushButton::clicked, this, &MainWindow::onPreviousQuestionClicked);
-    connect(m_nextButton, &QPushButton::clicked, this, &MainWindow::onNextQuestionClicked);
-    connect(m_endTestButton, &QPushButton::clicked, this, &MainWindow::onEndTestClicked);
-}
-
-void MainWindow::onEndTestClicked()
-{
-    if (m_quizManager->endTest()) {
-        showResults();
+    // Немодальное окно: можно держать открытым и наблюдать задержки во время работы
+    if (!m_diagnosticsDialog) {
+        m_diagnosticsDialog = new DiagnosticsDialog(this);
     }
+    m_diagnosticsDialog->show();
+    m_diagnosticsDialog->raise();
+    m_diagnosticsDialog->activateWindow();
 }
-
-void MainWindow::onNextQuestionClicked()
-{
-    if (m_quizManager->nextQuestion()) {
-        updateUI();
-    }
-}
-
-void MainWindow::onPreviousQuestionClicked()
-{
-    if (m_quizManager->previousQuestion()) {
-        updateUI();
-    }
-}
\ No newline at end of file
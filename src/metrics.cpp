@@ -0,0 +1,194 @@
+#include "metrics.h"
+#include "logger.h"
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QtAlgorithms>
+
+void LatencyHistogram::record(qint64 nanoseconds)
+{
+    const quint64 value = quint64(qMax<qint64>(0, nanoseconds));
+    m_counts[bucketOf(value)].fetchAndAddRelaxed(1);
+    m_count.fetchAndAddRelaxed(1);
+    m_sum.fetchAndAddRelaxed(value);
+    quint64 current = m_max.loadRelaxed();
+    while (value > current && !m_max.testAndSetRelaxed(current, value, current)) {
+    }
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other)
+{
+    for (int i = 0; i < BucketCount; ++i) {
+        const quint64 count = other.bucketCount(i);
+        if (count > 0) {
+            m_counts[i].fetchAndAddRelaxed(count);
+        }
+    }
+    m_count.fetchAndAddRelaxed(other.count());
+    m_sum.fetchAndAddRelaxed(other.sum());
+    const quint64 otherMax = other.max();
+    quint64 current = m_max.loadRelaxed();
+    while (otherMax > current && !m_max.testAndSetRelaxed(current, otherMax, current)) {
+    }
+}
+
+void LatencyHistogram::reset()
+{
+    for (QAtomicInteger<quint64>& count : m_counts) {
+        count.storeRelaxed(0);
+    }
+    m_count.storeRelaxed(0);
+    m_sum.storeRelaxed(0);
+    m_max.storeRelaxed(0);
+}
+
+quint64 LatencyHistogram::percentile(double q) const
+{
+    // Корзины читаются без блокировки: во время записи результат приблизителен
+    quint64 total = 0;
+    for (int i = 0; i < BucketCount; ++i) {
+        total += bucketCount(i);
+    }
+    if (total == 0) {
+        return 0;
+    }
+    const quint64 rank = qMax<quint64>(1, quint64(q * double(total) + 0.5));
+    quint64 seen = 0;
+    for (int i = 0; i < BucketCount; ++i) {
+        seen += bucketCount(i);
+        if (seen >= rank) {
+            return qMin(upperBound(i), max());
+        }
+    }
+    return max();
+}
+
+int LatencyHistogram::bucketOf(quint64 value)
+{
+    if (value < SubBucketCount) {
+        return int(value);
+    }
+    const int exponent = 63 - qCountLeadingZeroBits(value);
+    return (exponent - SubBucketBits + 1) * SubBucketCount
+        + int((value >> (exponent - SubBucketBits)) & (SubBucketCount - 1));
+}
+
+quint64 LatencyHistogram::lowerBound(int bucket)
+{
+    if (bucket < SubBucketCount) {
+        return quint64(bucket);
+    }
+    const int exponent = bucket / SubBucketCount + SubBucketBits - 1;
+    return quint64(SubBucketCount + bucket % SubBucketCount) << (exponent - SubBucketBits);
+}
+
+quint64 LatencyHistogram::upperBound(int bucket)
+{
+    return bucket + 1 < BucketCount ? lowerBound(bucket + 1) - 1 : ~quint64(0);
+}
+
+Metrics& Metrics::instance()
+{
+    static Metrics metrics;
+    return metrics;
+}
+
+LatencyHistogram& Metrics::histogram(const QString& name, const QString& help)
+{
+    QMutexLocker locker(&m_mutex);
+    for (const std::unique_ptr<Entry>& entry : m_entries) {
+        if (entry->name == name) {
+            return entry->histogram;
+        }
+    }
+    m_entries.emplace_back(new Entry);
+    m_entries.back()->name = name;
+    m_entries.back()->help = help;
+    return m_entries.back()->histogram;
+}
+
+QVector<Metrics::Summary> Metrics::summaries() const
+{
+    QMutexLocker locker(&m_mutex);
+    QVector<Summary> result;
+    result.reserve(int(m_entries.size()));
+    for (const std::unique_ptr<Entry>& entry : m_entries) {
+        const LatencyHistogram& histogram = entry->histogram;
+        Summary summary;
+        summary.name = entry->name;
+        summary.help = entry->help;
+        summary.count = histogram.count();
+        summary.sumSeconds = double(histogram.sum()) / 1e9;
+        summary.p50Seconds = double(histogram.percentile(0.50)) / 1e9;
+        summary.p95Seconds = double(histogram.percentile(0.95)) / 1e9;
+        summary.p99Seconds = double(histogram.percentile(0.99)) / 1e9;
+        summary.maxSeconds = double(histogram.max()) / 1e9;
+        result.append(summary);
+    }
+    return result;
+}
+
+void Metrics::reset()
+{
+    QMutexLocker locker(&m_mutex);
+    for (const std::unique_ptr<Entry>& entry : m_entries) {
+        entry->histogram.reset();
+    }
+}
+
+QByteArray Metrics::toPrometheus() const
+{
+    // Гистограммы выгружаются как summary: квантили, сумма и число наблюдений
+    QByteArray text;
+    for (const Summary& summary : summaries()) {
+        const QByteArray name = summary.name.toUtf8();
+        if (!summary.help.isEmpty()) {
+            text += "# HELP " + name + ' ' + summary.help.toUtf8() + '\n';
+        }
+        text += "# TYPE " + name + " summary\n";
+        text += name + "{quantile=\"0.5\"} " + QByteArray::number(summary.p50Seconds, 'g', 9) + '\n';
+        text += name + "{quantile=\"0.95\"} " + QByteArray::number(summary.p95Seconds, 'g', 9) + '\n';
+        text += name + "{quantile=\"0.99\"} " + QByteArray::number(summary.p99Seconds, 'g', 9) + '\n';
+        text += name + "{quantile=\"1\"} " + QByteArray::number(summary.maxSeconds, 'g', 9) + '\n';
+        text += name + "_sum " + QByteArray::number(summary.sumSeconds, 'g', 9) + '\n';
+        text += name + "_count " + QByteArray::number(summary.count) + '\n';
+    }
+    return text;
+}
+
+QByteArray Metrics::toJson() const
+{
+    QJsonArray metrics;
+    for (const Summary& summary : summaries()) {
+        QJsonObject object;
+        object["name"] = summary.name;
+        object["help"] = summary.help;
+        object["count"] = qint64(summary.count);
+        object["sum_seconds"] = summary.sumSeconds;
+        object["p50_seconds"] = summary.p50Seconds;
+        object["p95_seconds"] = summary.p95Seconds;
+        object["p99_seconds"] = summary.p99Seconds;
+        object["max_seconds"] = summary.maxSeconds;
+        metrics.append(object);
+    }
+    QJsonObject root;
+    root["metrics"] = metrics;
+    return QJsonDocument(root).toJson();
+}
+
+bool Metrics::writeToFile(const QString& filePath) const
+{
+    // QSaveFile подменяет файл целиком, поэтому сборщик метрик не прочитает его наполовину записанным
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        LOG_ERROR("Failed to open metrics file: " + filePath);
+        return false;
+    }
+    file.write(filePath.endsWith(".json", Qt::CaseInsensitive) ? toJson() : toPrometheus());
+    if (!file.commit()) {
+        LOG_ERROR("Failed to write metrics file: " + filePath);
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,73 @@
+#include "optionsampler.h"
+#include <utility>
+
+namespace {
+
+bool containsIndex(const int* begin, const int* end, int value)
+{
+    for (const int* p = begin; p != end; ++p) {
+        if (*p == value) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+OptionSampler::Sample OptionSampler::sample(int population, int correctIndex, int optionCount,
+                                            SessionRandom& generator)
+{
+    Sample result;
+    if (population <= 0 || correctIndex < 0 || correctIndex >= population) {
+        return result;
+    }
+
+    const int count = qBound(1, qMin(optionCount, population), int(MaxOptions));
+    result.indices[0] = correctIndex;
+    result.count = 1;
+
+    // Флойд: выбираем count - 1 различных индексов из population - 1 кандидатов,
+    // кандидаты не включают правильный ответ (индексы с correctIndex сдвигаются на единицу)
+    const int candidates = population - 1;
+    int* distractors = result.indices.data() + 1;
+    int chosen = 0;
+    for (int j = candidates - (count - 1); j < candidates; ++j) {
+        const int t = int(generator.bounded(quint32(j + 1)));
+        const int pick = containsIndex(distractors, distractors + chosen, t) ? j : t;
+        distractors[chosen++] = pick;
+    }
+    for (int i = 0; i < chosen; ++i) {
+        if (distractors[i] >= correctIndex) {
+            ++distractors[i];
+        }
+    }
+    result.count += chosen;
+
+    // Флойд не даёт равномерного порядка, поэтому перемешиваем короткий массив целиком
+    for (int i = result.count - 1; i > 0; --i) {
+        const int j = int(generator.bounded(quint32(i + 1)));
+        std::swap(result.indices[i], result.indices[j]);
+    }
+    for (int i = 0; i < result.count; ++i) {
+        if (result.indices[i] == correctIndex) {
+            result.correctPosition = i;
+            break;
+        }
+    }
+    return result;
+}
+
+OptionSampler::Permutation OptionSampler::permutation(int optionCount, SessionRandom& generator)
+{
+    Permutation result;
+    result.count = qBound(0, optionCount, int(MaxOptions));
+    for (int i = 0; i < result.count; ++i) {
+        result.order[i] = quint8(i);
+    }
+    for (int i = result.count - 1; i > 0; --i) {
+        const int j = int(generator.bounded(quint32(i + 1)));
+        std::swap(result.order[i], result.order[j]);
+    }
+    return result;
+}
@@ -0,0 +1,182 @@
+#include "parsecache.h"
+#include "questionbank.h"
+#include "logger.h"
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <cstring>
+
+namespace {
+
+const qint64 kHashChunkSize = 1 << 20;
+
+quint64 rotateLeft(quint64 value, int bits)
+{
+    return (value << bits) | (value >> (64 - bits));
+}
+
+quint64 mixWord(quint64 hash, quint64 word)
+{
+    hash ^= word * 0xC2B2AE3D27D4EB4FULL;
+    return rotateLeft(hash, 31) * 0x9E3779B185EBCA87ULL;
+}
+
+} // namespace
+
+QString ParseCache::cacheDirectory()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/banks";
+}
+
+quint64 ParseCache::hashFile(const QString& filePath, bool* ok)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (ok) {
+            *ok = false;
+        }
+        return 0;
+    }
+
+    // Быстрый некриптографический хэш по 8-байтовым словам, только для проверки кэша
+    quint64 hash = 0x9E3779B97F4A7C15ULL ^ quint64(file.size());
+    QByteArray chunk;
+    while (!(chunk = file.read(kHashChunkSize)).isEmpty()) {
+        const char* data = chunk.constData();
+        const qsizetype words = chunk.size() / 8;
+        for (qsizetype i = 0; i < words; ++i) {
+            quint64 word;
+            std::memcpy(&word, data + i * 8, sizeof(word));
+            hash = mixWord(hash, word);
+        }
+
+        quint64 tail = 0;
+        const qsizetype tailSize = chunk.size() - words * 8;
+        if (tailSize > 0) {
+            std::memcpy(&tail, data + words * 8, size_t(tailSize));
+            hash = mixWord(hash, tail ^ quint64(tailSize));
+        }
+    }
+
+    hash ^= hash >> 33;
+    hash *= 0xFF51AFD7ED558CCDULL;
+    hash ^= hash >> 33;
+
+    if (ok) {
+        *ok = file.error() == QFileDevice::NoError;
+    }
+    return hash;
+}
+
+QString ParseCache::entryPath(const QString& questionsFile, const QString& answersFile)
+{
+    const QByteArray key = QFileInfo(questionsFile).absoluteFilePath().toUtf8() + '\n'
+        + QFileInfo(answersFile).absoluteFilePath().toUtf8();
+    const QByteArray name = QCryptographicHash::hash(key, QCryptographicHash::Sha1).toHex();
+    return cacheDirectory() + "/" + QString::fromLatin1(name);
+}
+
+QJsonObject ParseCache::fileKey(const QString& filePath, bool withHash)
+{
+    const QFileInfo info(filePath);
+    QJsonObject key;
+    key["path"] = info.absoluteFilePath();
+    key["size"] = info.size();
+    key["modified"] = info.lastModified().toMSecsSinceEpoch();
+    if (withHash) {
+        bool ok = false;
+        const quint64 hash = hashFile(filePath, &ok);
+        key["hash"] = ok ? QString::number(hash, 16) : QString();
+    }
+    return key;
+}
+
+bool ParseCache::isFresh(QJsonObject& stored, const QString& filePath, bool* updated)
+{
+    const QFileInfo info(filePath);
+    if (!info.exists()
+        || stored["path"].toString() != info.absoluteFilePath()
+        || stored["size"].toInteger() != info.size()) {
+        return false;
+    }
+
+    const qint64 modified = info.lastModified().toMSecsSinceEpoch();
+    if (stored["modified"].toInteger() == modified) {
+        return true;
+    }
+
+    // Время изменения другое, но размер совпал: сверяем содержимое по хэшу
+    bool ok = false;
+    const QString hash = QString::number(hashFile(filePath, &ok), 16);
+    if (!ok || stored["hash"].toString().isEmpty() || stored["hash"].toString() != hash) {
+        return false;
+    }
+
+    stored["modified"] = modified;
+    *updated = true;
+    return true;
+}
+
+QSharedPointer<const QuestionBank> ParseCache::load(const QString& questionsFile, const QString& answersFile)
+{
+    const QString entry = entryPath(questionsFile, answersFile);
+    const QString snapshotFile = entry + QuestionBank::compiledSuffix();
+    const QString metaFile = entry + ".json";
+
+    QFile meta(metaFile);
+    if (meta.open(QIODevice::ReadOnly)) {
+        QJsonObject stored = QJsonDocument::fromJson(meta.readAll()).object();
+        meta.close();
+
+        QJsonObject questionsKey = stored["questions"].toObject();
+        QJsonObject answersKey = stored["answers"].toObject();
+        bool updated = false;
+        if (isFresh(questionsKey, questionsFile, &updated) && isFresh(answersKey, answersFile, &updated)) {
+            QSharedPointer<const QuestionBank> bank = QuestionBank::fromCompiledFile(snapshotFile);
+            if (bank) {
+                if (updated) {
+                    stored["questions"] = questionsKey;
+                    stored["answers"] = answersKey;
+                    QSaveFile metaOut(metaFile);
+                    if (metaOut.open(QIODevice::WriteOnly)) {
+                        metaOut.write(QJsonDocument(stored).toJson(QJsonDocument::Compact));
+                        metaOut.commit();
+                    }
+                }
+                LOG_INFO("Parse cache hit for " + questionsFile);
+                return bank;
+            }
+        }
+    }
+
+    // Снимок отсутствует или устарел: разбираем текст и обновляем кэш
+    const QJsonObject questionsKey = fileKey(questionsFile, true);
+    const QJsonObject answersKey = fileKey(answersFile, true);
+
+    QVector<QuestionBank::Question> questions;
+    if (!QuestionBank::loadQuestionsFromFile(questionsFile, questions) ||
+        !QuestionBank::loadAnswersFromFile(answersFile, questions)) {
+        return QSharedPointer<const QuestionBank>();
+    }
+
+    if (QDir().mkpath(cacheDirectory()) && QuestionBank::writeCompiledFile(questions, snapshotFile)) {
+        QJsonObject stored;
+        stored["questions"] = questionsKey;
+        stored["answers"] = answersKey;
+        QSaveFile metaOut(metaFile);
+        if (!metaOut.open(QIODevice::WriteOnly)
+            || metaOut.write(QJsonDocument(stored).toJson(QJsonDocument::Compact)) < 0
+            || !metaOut.commit()) {
+            LOG_WARNING("Failed to write parse cache entry: " + metaFile);
+        }
+    } else {
+        LOG_WARNING("Failed to write parse cache snapshot: " + snapshotFile);
+    }
+
+    return QuestionBank::fromQuestions(questions);
+}
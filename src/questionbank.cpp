@@ -0,0 +1,485 @@
+#include "questionbank.h"
+#include "logger.h"
+#include "parsecache.h"
+#include "lineparser.h"
+#include "metrics.h"
+#include <QSaveFile>
+#include <cstring>
+
+namespace {
+
+const char kMagic[4] = { 'Q', 'Z', 'B', '1' };
+// Версия 2: банк проверяется при записи, поэтому открытие не просматривает вопросы
+const quint32 kVersion = 2;
+
+} // namespace
+
+// Формат .qzb: заголовок, таблица вопросов, таблица вариантов ответов и
+// строки в UTF-16, чтобы их можно было отдавать прямо из отображённой памяти.
+struct QuestionBank::Header {
+    char magic[4];
+    quint32 version;
+    quint32 questionCount;
+    quint32 optionCount;
+    quint64 questionTableOffset;
+    quint64 optionTableOffset;
+    quint64 stringsOffset;
+    quint64 stringsLength;
+};
+
+struct QuestionBank::QuestionRecord {
+    quint32 textOffset;
+    quint32 textLength;
+    quint32 firstOption;
+    quint16 optionCount;
+    qint16 correctOption;
+};
+
+struct QuestionBank::OptionRecord {
+    quint32 offset;
+    quint32 length;
+};
+
+bool QuestionBank::isCompiledFile(const QString& filePath)
+{
+    return filePath.endsWith(QLatin1String(compiledSuffix()), Qt::CaseInsensitive);
+}
+
+QSharedPointer<const QuestionBank> QuestionBank::load(const QString& questionsFile, const QString& answersFile)
+{
+    METRICS_SCOPED_TIMER("quizown_section_load_seconds", "Loading a section question bank");
+
+    if (isCompiledFile(questionsFile)) {
+        return fromCompiledFile(questionsFile);
+    }
+
+    // Текстовые файлы разбираются заново, только если их снимка нет в кэше или он устарел
+    return ParseCache::load(questionsFile, answersFile);
+}
+
+QSharedPointer<const QuestionBank> QuestionBank::fromQuestions(const QVector<Question>& questions)
+{
+    QSharedPointer<QuestionBank> bank(new QuestionBank);
+
+    qsizetype optionCount = 0;
+    for (const Question& question : questions) {
+        optionCount += question.options.size();
+    }
+    bank->m_pooledQuestions.reserve(questions.size());
+    bank->m_pooledOptions.reserve(optionCount);
+
+    // Повторяющиеся варианты ответов ("Да"/"Нет", типовые дистракторы) хранятся в пуле один раз
+    for (const Question& question : questions) {
+        PooledQuestion record;
+        record.text = bank->m_strings.intern(question.text);
+        record.firstOption = quint32(bank->m_pooledOptions.size());
+        record.optionCount = quint16(qMin<qsizetype>(question.options.size(), 0xFFFF));
+        record.correctOption = qint16(question.correctOption);
+        for (int i = 0; i < record.optionCount; ++i) {
+            bank->m_pooledOptions.append(bank->m_strings.intern(question.options.at(i)));
+        }
+        bank->m_pooledQuestions.append(record);
+    }
+    bank->m_strings.squeeze();
+
+    // Оценка занимаемой памяти считается один раз, банк неизменяем
+    bank->m_memoryUsage = bank->m_strings.memoryUsage()
+        + qint64(bank->m_pooledQuestions.capacity()) * qint64(sizeof(PooledQuestion))
+        + qint64(bank->m_pooledOptions.capacity()) * qint64(sizeof(StringPool::Handle));
+    return bank;
+}
+
+QSharedPointer<const QuestionBank> QuestionBank::fromCompiledFile(const QString& filePath)
+{
+    QSharedPointer<QuestionBank> bank(new QuestionBank);
+    if (!bank->mapFile(filePath)) {
+        return QSharedPointer<const QuestionBank>();
+    }
+
+    LOG_INFO("Mapped " + QString::number(bank->size()) + " questions from " + filePath);
+    return bank;
+}
+
+QuestionBank::~QuestionBank()
+{
+    if (m_file && m_mapped) {
+        m_file->unmap(const_cast<uchar*>(m_mapped));
+    }
+}
+
+bool QuestionBank::loadQuestionsFromFile(const QString& filePath, QVector<Question>& questions)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        LOG_ERROR("Failed to open questions file: " + filePath);
+        return false;
+    }
+
+    questions.clear();
+    LineReader reader(&file);
+    QByteArrayView line;
+    while (reader.next(line)) {
+        Question question;
+        question.text = QString::fromUtf8(line);
+        questions.append(question);
+    }
+
+    if (reader.hasError()) {
+        LOG_ERROR("Failed to read questions file: " + filePath + ": " + file.errorString());
+        questions.clear();
+        return false;
+    }
+    if (reader.hasInvalidUtf8()) {
+        LOG_WARNING("Questions file is not valid UTF-8: " + filePath);
+    }
+    LOG_INFO("Loaded " + QString::number(questions.size()) + " questions from " + filePath);
+    file.close();
+    return true;
+}
+
+bool QuestionBank::loadAnswersFromFile(const QString& filePath, QVector<Question>& questions)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        LOG_ERROR("Failed to open answers file: " + filePath);
+        return false;
+    }
+
+    for (Question& question : questions) {
+        question.options.clear();
+        question.correctOption = -1;
+    }
+
+    const QByteArrayView marker("{ans}");
+    int answersCount = 0;
+    LineReader reader(&file);
+    QByteArrayView line;
+    while (reader.next(line)) {
+        // Формат строки: "N. Текст ответа", правильный ответ помечен маркером {ans}
+        qsizetype digits = 0;
+        qint64 number = 0;
+        while (digits < line.size() && digits < 10 && line[digits] >= '0' && line[digits] <= '9') {
+            number = number * 10 + (line[digits] - '0');
+            ++digits;
+        }
+        if (digits == 0 || digits >= line.size() || line[digits] != '.'
+            || number < 1 || number > questions.size()) {
+            LOG_WARNING("Skipping answer with invalid question number in " + filePath + ": "
+                        + QString::fromUtf8(line));
+            continue;
+        }
+
+        Question& question = questions[int(number - 1)];
+        const QByteArrayView text = line.sliced(digits + 1);
+        const qsizetype markerIndex = LineScanner::indexOf(text, marker);
+        QString option;
+        if (markerIndex >= 0) {
+            option = QString::fromUtf8(text.first(markerIndex));
+            if (markerIndex + marker.size() < text.size()) {
+                option += QString::fromUtf8(text.sliced(markerIndex + marker.size()));
+            }
+            question.correctOption = question.options.size();
+        } else {
+            option = QString::fromUtf8(text);
+        }
+        question.options.append(std::move(option).trimmed());
+        ++answersCount;
+    }
+
+    if (reader.hasError()) {
+        LOG_ERROR("Failed to read answers file: " + filePath + ": " + file.errorString());
+        return false;
+    }
+    if (reader.hasInvalidUtf8()) {
+        LOG_WARNING("Answers file is not valid UTF-8: " + filePath);
+    }
+    LOG_INFO("Loaded " + QString::number(answersCount) + " answers from " + filePath);
+    file.close();
+    return true;
+}
+
+bool QuestionBank::compile(const QString& questionsFile, const QString& answersFile, const QString& outputFile)
+{
+    QVector<Question> questions;
+    if (!loadQuestionsFromFile(questionsFile, questions) ||
+        !loadAnswersFromFile(answersFile, questions)) {
+        return false;
+    }
+    return writeCompiledFile(questions, outputFile);
+}
+
+bool QuestionBank::writeCompiledFile(const QVector<Question>& questions, const QString& outputFile)
+{
+    static_assert(sizeof(Header) == 48, "unexpected .qzb header layout");
+    static_assert(sizeof(QuestionRecord) == 16, "unexpected .qzb question record layout");
+    static_assert(sizeof(OptionRecord) == 8, "unexpected .qzb option record layout");
+
+    // Проверка та же, что в isValid(): у открытого снимка она уже не повторяется
+    if (questions.isEmpty()) {
+        LOG_ERROR("Refusing to compile an empty question bank: " + outputFile);
+        return false;
+    }
+    for (int i = 0; i < questions.size(); ++i) {
+        const Question& question = questions[i];
+        if (question.options.size() < 2 || question.correctOption < 0
+            || question.correctOption >= question.options.size()) {
+            LOG_ERROR("Question " + QString::number(i + 1) + " has no valid answer options, not compiling: "
+                      + outputFile);
+            return false;
+        }
+    }
+
+    QVector<QuestionRecord> questionTable;
+    QVector<OptionRecord> optionTable;
+    StringPool strings;
+    questionTable.reserve(questions.size());
+
+    // Одинаковые строки попадают в таблицу строк снимка один раз
+    bool overflow = false;
+    auto appendString = [&strings, &overflow](const QString& value, quint32& offset, quint32& length) {
+        const StringPool::Handle handle = strings.intern(value);
+        overflow = overflow || handle == StringPool::InvalidHandle;
+        offset = overflow ? 0 : strings.offset(handle);
+        length = quint32(value.size());
+    };
+
+    for (const Question& question : questions) {
+        if (question.options.size() > 0xFFFF) {
+            LOG_ERROR("Too many options for a compiled question: " + question.text);
+            return false;
+        }
+
+        QuestionRecord record;
+        appendString(question.text, record.textOffset, record.textLength);
+        record.firstOption = quint32(optionTable.size());
+        record.optionCount = quint16(question.options.size());
+        record.correctOption = qint16(question.correctOption);
+        for (const QString& option : question.options) {
+            OptionRecord optionRecord;
+            appendString(option, optionRecord.offset, optionRecord.length);
+            optionTable.append(optionRecord);
+        }
+        questionTable.append(record);
+
+        if (overflow) {
+            LOG_ERROR("Question bank is too large to compile: " + outputFile);
+            return false;
+        }
+    }
+
+    Header header;
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.questionCount = quint32(questionTable.size());
+    header.optionCount = quint32(optionTable.size());
+    header.questionTableOffset = sizeof(Header);
+    header.optionTableOffset = header.questionTableOffset + quint64(questionTable.size()) * sizeof(QuestionRecord);
+    header.stringsOffset = header.optionTableOffset + quint64(optionTable.size()) * sizeof(OptionRecord);
+    header.stringsLength = quint64(strings.characterCount());
+
+    QSaveFile file(outputFile);
+    if (!file.open(QIODevice::WriteOnly)) {
+        LOG_ERROR("Failed to open compiled bank for writing: " + outputFile);
+        return false;
+    }
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(questionTable.constData()),
+               qint64(questionTable.size()) * qint64(sizeof(QuestionRecord)));
+    file.write(reinterpret_cast<const char*>(optionTable.constData()),
+               qint64(optionTable.size()) * qint64(sizeof(OptionRecord)));
+    file.write(reinterpret_cast<const char*>(strings.data().data()),
+               strings.characterCount() * qint64(sizeof(QChar)));
+
+    if (!file.commit()) {
+        LOG_ERROR("Failed to write compiled bank: " + outputFile);
+        return false;
+    }
+
+    LOG_INFO("Compiled " + QString::number(questions.size()) + " questions to " + outputFile);
+    return true;
+}
+
+bool QuestionBank::mapFile(const QString& filePath)
+{
+    m_file.reset(new QFile(filePath));
+    if (!m_file->open(QIODevice::ReadOnly)) {
+        LOG_ERROR("Failed to open compiled bank: " + filePath);
+        return false;
+    }
+
+    const qint64 fileSize = m_file->size();
+    if (fileSize < qint64(sizeof(Header))) {
+        LOG_ERROR("Compiled bank is truncated: " + filePath);
+        return false;
+    }
+
+    const uchar* mapped = m_file->map(0, fileSize);
+    if (!mapped) {
+        LOG_ERROR("Failed to map compiled bank: " + filePath);
+        return false;
+    }
+
+    // Проверяется только заголовок и границы таблиц, поэтому открытие не зависит от размера банка.
+    // Размер таблицы сравнивается с остатком файла после её начала, чтобы повреждённый
+    // заголовок не мог переполнить сумму смещения и длины.
+    const Header* header = reinterpret_cast<const Header*>(mapped);
+    const quint64 size = quint64(fileSize);
+    const auto fits = [size](quint64 offset, quint64 count, quint64 recordSize) {
+        return offset <= size && count <= (size - offset) / recordSize;
+    };
+
+    const bool valid = std::memcmp(header->magic, kMagic, sizeof(kMagic)) == 0
+        && header->version == kVersion
+        && header->questionTableOffset % alignof(QuestionRecord) == 0
+        && header->optionTableOffset % alignof(OptionRecord) == 0
+        && header->stringsOffset % alignof(QChar) == 0
+        && fits(header->questionTableOffset, header->questionCount, sizeof(QuestionRecord))
+        && fits(header->optionTableOffset, header->optionCount, sizeof(OptionRecord))
+        && fits(header->stringsOffset, header->stringsLength, sizeof(QChar));
+    if (!valid) {
+        LOG_ERROR("Invalid compiled bank: " + filePath);
+        m_file->unmap(const_cast<uchar*>(mapped));
+        return false;
+    }
+
+    m_mapped = mapped;
+    m_header = header;
+    m_questionTable = reinterpret_cast<const QuestionRecord*>(mapped + header->questionTableOffset);
+    m_optionTable = reinterpret_cast<const OptionRecord*>(mapped + header->optionTableOffset);
+    m_mappedStrings = reinterpret_cast<const QChar*>(mapped + header->stringsOffset);
+    m_memoryUsage = fileSize;
+    return true;
+}
+
+QStringView QuestionBank::stringAt(quint32 offset, quint32 length) const
+{
+    if (quint64(offset) + length > m_header->stringsLength) {
+        return QStringView();
+    }
+    return QStringView(m_mappedStrings + offset, qsizetype(length));
+}
+
+int QuestionBank::size() const
+{
+    return m_mapped ? int(m_header->questionCount) : int(m_pooledQuestions.size());
+}
+
+bool QuestionBank::isValid() const
+{
+    if (isEmpty()) {
+        return false;
+    }
+
+    // Снимок проверен при записи (writeCompiledFile), поэтому открытие остаётся O(1)
+    if (m_mapped) {
+        return true;
+    }
+
+    for (int i = 0; i < size(); ++i) {
+        if (optionCount(i) < 2 || correctOption(i) < 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+QStringView QuestionBank::textView(int index) const
+{
+    if (m_mapped) {
+        if (index < 0 || quint32(index) >= m_header->questionCount) {
+            return QStringView();
+        }
+        const QuestionRecord& record = m_questionTable[index];
+        return stringAt(record.textOffset, record.textLength);
+    }
+    if (index < 0 || index >= m_pooledQuestions.size()) {
+        return QStringView();
+    }
+    return m_strings.view(m_pooledQuestions[index].text);
+}
+
+QStringView QuestionBank::optionView(int index, int option) const
+{
+    if (m_mapped) {
+        if (index < 0 || quint32(index) >= m_header->questionCount) {
+            return QStringView();
+        }
+        const QuestionRecord& record = m_questionTable[index];
+        const quint64 optionIndex = quint64(record.firstOption) + quint64(option);
+        if (option < 0 || option >= record.optionCount || optionIndex >= m_header->optionCount) {
+            return QStringView();
+        }
+        const OptionRecord& optionRecord = m_optionTable[optionIndex];
+        return stringAt(optionRecord.offset, optionRecord.length);
+    }
+    if (index < 0 || index >= m_pooledQuestions.size()) {
+        return QStringView();
+    }
+    const PooledQuestion& record = m_pooledQuestions[index];
+    if (option < 0 || option >= record.optionCount) {
+        return QStringView();
+    }
+    return m_strings.view(m_pooledOptions[record.firstOption + quint32(option)]);
+}
+
+QString QuestionBank::correctAnswer(int index) const
+{
+    const int correct = correctOption(index);
+    return correct >= 0 ? option(index, correct) : QString();
+}
+
+QStringList QuestionBank::options(int index) const
+{
+    QStringList result;
+    const int count = optionCount(index);
+    result.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        result.append(option(index, i));
+    }
+    return result;
+}
+
+QVector<QuestionBank::Question> QuestionBank::toQuestions() const
+{
+    QVector<Question> result;
+    result.reserve(size());
+    for (int i = 0; i < size(); ++i) {
+        Question question;
+        question.text = text(i);
+        question.options = options(i);
+        question.correctOption = correctOption(i);
+        result.append(question);
+    }
+    return result;
+}
+
+int QuestionBank::optionCount(int index) const
+{
+    if (m_mapped) {
+        if (index < 0 || quint32(index) >= m_header->questionCount) {
+            return 0;
+        }
+        return m_questionTable[index].optionCount;
+    }
+    if (index < 0 || index >= m_pooledQuestions.size()) {
+        return 0;
+    }
+    return m_pooledQuestions[index].optionCount;
+}
+
+int QuestionBank::correctOption(int index) const
+{
+    if (m_mapped) {
+        if (index < 0 || quint32(index) >= m_header->questionCount) {
+            return -1;
+        }
+        const QuestionRecord& record = m_questionTable[index];
+        return record.correctOption < record.optionCount ? record.correctOption : -1;
+    }
+    if (index < 0 || index >= m_pooledQuestions.size()) {
+        return -1;
+    }
+    const PooledQuestion& record = m_pooledQuestions[index];
+    return record.correctOption < record.optionCount ? record.correctOption : -1;
+}
@@ -1,5 +1,8 @@
 #include "../include/quizmanager.h"
 #include "../include/logger.h"
+#include "../include/metrics.h"
+#include "../include/optionsampler.h"
+#include "../include/sessionrandom.h"
 #include <QFile>
 #include <QTextStream>
 #include <QDir>
@@ -12,19 +15,29 @@
 #include <QJsonArray>
 #include <QJsonValue>
 #include <QDebug>
-#include <QRandomGenerator>
+#include <QtConcurrent>
+#include <algorithm>
 
 QuizManager::QuizManager(QObject *parent)
     : QObject(parent)
+    , m_currentSectionId(InvalidSection)
     , m_isTestActive(false)
     , m_isMarathonActive(false)
-    , m_currentQuestionIndex(0)
-    , m_correctAnswers(0)
-    , m_currentMarathonSectionIndex(0)
-    , m_currentMarathonQuestionIndex(0)
-    , m_marathonCorrectAnswers(0)
 {
-    // Load sections from file
+    // Изменения файлов загруженных разделов подхватываются с небольшой задержкой,
+    // чтобы редактор успел дописать файл
+    m_reloadTimer.setSingleShot(true);
+    m_reloadTimer.setInterval(200);
+    connect(&m_reloadTimer, &QTimer::timeout, this, &QuizManager::reloadChangedFiles);
+    connect(&m_fileWatcher, &QFileSystemWatcher::fileChanged, this, &QuizManager::onWatchedFileChanged);
+    connect(&m_fileWatcher, &QFileSystemWatcher::directoryChanged, this, &QuizManager::onWatchedDirectoryChanged);
+
+    QSettings settings;
+    m_memoryBudget = settings.value("memoryBudgetMB", 512).toLongLong() * 1024 * 1024;
+    m_answerOptionCount = qBound(2, settings.value("answerOptionCount", 4).toInt(), int(OptionSampler::MaxOptions));
+    m_shuffleSeed = settings.value("shuffleSeed", 0).toULongLong();
+
+    // Загружаем только описание разделов, тела подгружаются при первом обращении
     QFile file("sections.json");
     if (file.open(QIODevice::ReadOnly)) {
         QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
@@ -36,18 +49,12 @@ QuizManager::QuizManager(QObject *parent)
             section.name = key;
             section.questionsFile = sectionObj["questionsFile"].toString();
             section.answersFile = sectionObj["answersFile"].toString();
-            
-            if (loadQuestionsFromFile(section.questionsFile, section.questions) &&
-                loadAnswersFromFile(section.answersFile, section.answers)) {
-                m_sections[key] = section;
-                qDebug() << "[INFO] Section loaded:" << key;
-            } else {
-                qDebug() << "[ERROR] Failed to load section:" << key;
-            }
+            insertSection(section);
         }
         file.close();
     }
-    LOG_INFO("QuizManager initialized");
+
+    LOG_INFO("QuizManager initialized with " + QString::number(m_sections.size()) + " sections");
 }
 
 QuizManager::~QuizManager()
@@ -56,24 +63,301 @@ QuizManager::~QuizManager()
     LOG_INFO("QuizManager destroyed");
 }
 
-bool QuizManager::addSection(const QString& name, const QString& questionsFile, const QString& answersFile)
+QuizManager::Section QuizManager::loadSection(const Section& entry)
 {
-    if (m_sections.contains(name)) {
-        LOG_ERROR("Section already exists: " + name);
+    Section section = entry;
+    section.bank = QuestionBank::load(section.questionsFile, section.answersFile);
+    return section;
+}
+
+QuizManager::SectionId QuizManager::insertSection(const Section& section)
+{
+    SectionId id;
+    if (!m_freeSectionIds.isEmpty()) {
+        id = m_freeSectionIds.takeLast();
+        m_sections[id] = section;
+    } else {
+        id = SectionId(m_sections.size());
+        m_sections.append(section);
+    }
+    m_sectionIds.insert(section.name, id);
+    return id;
+}
+
+bool QuizManager::loadSectionBodies(const QVector<SectionId>& ids)
+{
+    QVector<SectionId> pendingIds;
+    QVector<Section> pending;
+    for (SectionId id : ids) {
+        const Section& section = m_sections[id];
+        if (!section.isLoaded()) {
+            pendingIds.append(id);
+            pending.append(section);
+        }
+        touchSection(id);
+    }
+
+    if (pending.isEmpty()) {
+        return true;
+    }
+
+    // Несколько разделов (марафон) загружаются параллельно в пуле потоков
+    const QVector<Section> loaded = pending.size() == 1
+        ? QVector<Section>{ loadSection(pending.first()) }
+        : QtConcurrent::blockingMapped<QVector<Section>>(pending, &QuizManager::loadSection);
+
+    // blockingMapped сохраняет порядок, поэтому результат сопоставляется с номерами по позиции
+    bool ok = true;
+    for (int i = 0; i < loaded.size(); ++i) {
+        const Section& section = loaded[i];
+        if (!section.isLoaded()) {
+            LOG_ERROR("Failed to load section: " + section.name);
+            ok = false;
+            continue;
+        }
+        // Файлы могли измениться после добавления раздела: неполный банк не устанавливаем
+        if (!section.bank->isValid()) {
+            LOG_ERROR("Questions and answers mismatch for section: " + section.name);
+            ok = false;
+            continue;
+        }
+        m_sections[pendingIds[i]].bank = section.bank;
+        watchSection(pendingIds[i]);
+        LOG_INFO("Section loaded: " + section.name);
+    }
+    return ok;
+}
+
+void QuizManager::touchSection(SectionId id)
+{
+    m_recentSections.removeOne(id);
+    m_recentSections.prepend(id);
+}
+
+bool QuizManager::isSectionPinned(SectionId id) const
+{
+    return (m_isTestActive && m_currentSectionId == id)
+        || (m_isMarathonActive && m_marathonSections.contains(id));
+}
+
+void QuizManager::releaseBank(Section& section)
+{
+    if (section.isLoaded()) {
+        m_releasedBanks.append({ section.bank.toWeakRef(), section.memoryUsage() });
+        section.bank.reset();
+    }
+}
+
+void QuizManager::setMemoryBudget(qint64 bytes)
+{
+    m_memoryBudget = bytes;
+    enforceMemoryBudget();
+}
+
+void QuizManager::setAnswerOptionCount(int count)
+{
+    m_answerOptionCount = qBound(2, count, int(OptionSampler::MaxOptions));
+}
+
+qint64 QuizManager::loadedSectionsMemory() const
+{
+    qint64 total = 0;
+    for (SectionId id : m_recentSections) {
+        total += m_sections[id].memoryUsage();
+    }
+    for (const ReleasedBank& released : m_releasedBanks) {
+        if (!released.bank.isNull()) {
+            total += released.memoryUsage;
+        }
+    }
+    return total;
+}
+
+void QuizManager::enforceMemoryBudget()
+{
+    m_releasedBanks.erase(std::remove_if(m_releasedBanks.begin(), m_releasedBanks.end(),
+                                         [](const ReleasedBank& released) { return released.bank.isNull(); }),
+                          m_releasedBanks.end());
+    qint64 total = loadedSectionsMemory();
+
+    // Выгружаем давно не использовавшиеся разделы, кроме занятых текущим тестом или марафоном
+    for (int i = m_recentSections.size() - 1; i >= 0 && total > m_memoryBudget; --i) {
+        const SectionId id = m_recentSections.at(i);
+        if (isSectionPinned(id)) {
+            continue;
+        }
+
+        // Банк, который ещё держит сессия сервера, освободится позже и пока остаётся в total
+        Section& section = m_sections[id];
+        const QWeakPointer<const QuestionBank> bank = section.bank.toWeakRef();
+        const qint64 memoryUsage = section.memoryUsage();
+        releaseBank(section);
+        if (bank.isNull()) {
+            total -= memoryUsage;
+        }
+        unwatchSection(id);
+        m_recentSections.removeAt(i);
+        LOG_INFO("Section unloaded to fit memory budget: " + section.name);
+    }
+
+    if (total > m_memoryBudget) {
+        LOG_WARNING("Active sections exceed memory budget: " + QString::number(total) + " bytes");
+    }
+}
+
+void QuizManager::watchSection(SectionId id)
+{
+    const Section& section = m_sections[id];
+    for (const QString& filePath : { section.questionsFile, section.answersFile }) {
+        if (filePath.isEmpty()) {
+            continue;
+        }
+        // Наблюдение ставится только для первого раздела с этим файлом
+        QVector<SectionId>& ids = m_watchedFiles[filePath];
+        if (ids.isEmpty()) {
+            m_fileWatcher.addPath(filePath);
+        }
+        if (!ids.contains(id)) {
+            ids.append(id);
+        }
+    }
+}
+
+void QuizManager::unwatchSection(SectionId id)
+{
+    const Section& section = m_sections[id];
+    for (const QString& filePath : { section.questionsFile, section.answersFile }) {
+        auto it = m_watchedFiles.find(filePath);
+        if (it == m_watchedFiles.end()) {
+            continue;
+        }
+        it->removeOne(id);
+        if (it->isEmpty()) {
+            m_watchedFiles.erase(it);
+            m_fileWatcher.removePath(filePath);
+            if (m_missingFiles.remove(filePath)) {
+                onWatchedDirectoryChanged(QFileInfo(filePath).absolutePath());
+            }
+        }
+    }
+}
+
+void QuizManager::onWatchedFileChanged(const QString& filePath)
+{
+    m_changedFiles.insert(filePath);
+    m_reloadTimer.start();
+}
+
+void QuizManager::onWatchedDirectoryChanged(const QString& directory)
+{
+    // Появившийся файл обрабатывается как изменённый; каталог перестаёт наблюдаться,
+    // когда в нём не остаётся ожидаемых файлов
+    bool waiting = false;
+    for (auto it = m_missingFiles.begin(); it != m_missingFiles.end();) {
+        if (QFileInfo(*it).absolutePath() != directory) {
+            ++it;
+        } else if (QFileInfo::exists(*it)) {
+            onWatchedFileChanged(*it);
+            it = m_missingFiles.erase(it);
+        } else {
+            waiting = true;
+            ++it;
+        }
+    }
+    if (!waiting) {
+        m_fileWatcher.removePath(directory);
+    }
+}
+
+void QuizManager::reloadChangedFiles()
+{
+    const QSet<QString> changedFiles = m_changedFiles;
+    m_changedFiles.clear();
+
+    // Редакторы часто сохраняют файл через удаление и переименование, и наблюдение за ним снимается.
+    // После паузы файл либо уже на месте и наблюдается заново, либо ожидается через его каталог
+    for (const QString& filePath : changedFiles) {
+        if (!m_watchedFiles.contains(filePath)) {
+            continue;
+        }
+        if (QFileInfo::exists(filePath)) {
+            m_fileWatcher.addPath(filePath);
+        } else if (!m_missingFiles.contains(filePath)) {
+            m_missingFiles.insert(filePath);
+            m_fileWatcher.addPath(QFileInfo(filePath).absolutePath());
+        }
+    }
+
+    QSet<SectionId> sectionIds;
+    for (const QString& filePath : changedFiles) {
+        for (SectionId id : m_watchedFiles.value(filePath)) {
+            sectionIds.insert(id);
+        }
+    }
+
+    for (SectionId id : sectionIds) {
+        const Section& section = m_sections[id];
+        reloadSection(id,
+                      changedFiles.contains(section.questionsFile),
+                      changedFiles.contains(section.answersFile));
+    }
+}
+
+bool QuizManager::reloadSection(SectionId id, bool questionsChanged, bool answersChanged)
+{
+    Section& section = m_sections[id];
+    const QString name = section.name;
+    if (!section.isLoaded()) {
         return false;
     }
 
-    QVector<QString> questions;
-    QVector<QString> answers;
+    QSharedPointer<const QuestionBank> bank;
+    if (QuestionBank::isCompiledFile(section.questionsFile)) {
+        bank = QuestionBank::fromCompiledFile(section.questionsFile);
+    } else {
+        // Перечитываем только изменившийся файл, вторая половина берётся из текущего банка
+        QVector<QuestionBank::Question> questions = section.bank->toQuestions();
+        if (questionsChanged) {
+            QVector<QuestionBank::Question> reloaded;
+            if (!QuestionBank::loadQuestionsFromFile(section.questionsFile, reloaded)) {
+                return false;
+            }
+            if (reloaded.size() != questions.size()) {
+                // Номера ответов ссылаются на вопросы, поэтому при смене количества перечитываем и ответы
+                answersChanged = true;
+            } else {
+                for (int i = 0; i < reloaded.size(); ++i) {
+                    reloaded[i].options = questions[i].options;
+                    reloaded[i].correctOption = questions[i].correctOption;
+                }
+            }
+            questions = reloaded;
+        }
+        if (answersChanged && !QuestionBank::loadAnswersFromFile(section.answersFile, questions)) {
+            return false;
+        }
+        bank = QuestionBank::fromQuestions(questions);
+    }
 
-    if (!loadQuestionsFromFile(questionsFile, questions) ||
-        !loadAnswersFromFile(answersFile, answers)) {
+    // Файл мог быть сохранён не полностью: оставляем прежний банк до следующего изменения
+    if (!bank || !bank->isValid()) {
+        LOG_WARNING("Changed section files are not valid yet, keeping previous version: " + name);
         return false;
     }
 
-    // Проверяем, что количество ответов в 4 раза больше количества вопросов
-    if (answers.size() != questions.size() * 4) {
-        LOG_ERROR("Questions and answers count mismatch for section: " + name);
+    releaseBank(section);
+    section.bank = bank;
+    LOG_INFO("Section reloaded: " + name + " (" + QString::number(bank->size()) + " questions)");
+
+    updateSessions(id);
+    emit sectionReloaded(name);
+    return true;
+}
+
+bool QuizManager::addSection(const QString& name, const QString& questionsFile, const QString& answersFile)
+{
+    if (m_sectionIds.contains(name)) {
+        LOG_ERROR("Section already exists: " + name);
         return false;
     }
 
@@ -81,98 +365,165 @@ bool QuizManager::addSection(const QString& name, const QString& questionsFile,
     section.name = name;
     section.questionsFile = questionsFile;
     section.answersFile = answersFile;
-    section.questions = questions;
-    section.answers = answers;
 
-    m_sections[name] = section;
+    section.bank = QuestionBank::load(questionsFile, answersFile);
+    if (!section.bank) {
+        return false;
+    }
+
+    // Проверяем, что у каждого вопроса есть варианты и отмечен правильный ответ
+    if (!section.bank->isValid()) {
+        LOG_ERROR("Questions and answers mismatch for section: " + name);
+        return false;
+    }
+
+    const SectionId id = insertSection(section);
+    watchSection(id);
+    touchSection(id);
+    enforceMemoryBudget();
     emit sectionAdded(name);
     return true;
 }
 
 bool QuizManager::removeSection(const QString &name)
 {
-    if (!m_sections.contains(name)) {
+    const SectionId id = sectionId(name);
+    if (id == InvalidSection) {
         qDebug() << "[ERROR] Section does not exist:" << name;
         return false;
     }
 
-    m_sections.remove(name);
-    emit sectionRemoved(name);
+    // Тест и марафон держат номера разделов, а слот будет переиспользован,
+    // поэтому удаление их раздела завершает их
+    if (m_isTestActive && m_currentSectionId == id) {
+        LOG_WARNING("Section removed during test, ending test: " + name);
+        endTest();
+    }
+    if (m_isMarathonActive && m_marathonSections.contains(id)) {
+        LOG_WARNING("Section removed during marathon, ending marathon: " + name);
+        endMarathon();
+    }
+    if (m_currentSectionId == id) {
+        m_currentSectionId = InvalidSection;
+    }
+
+    unwatchSection(id);
+    releaseBank(m_sections[id]);
+    m_sections[id] = Section();
+    m_sectionIds.remove(name);
+    m_freeSectionIds.append(id);
+    m_recentSections.removeOne(id);
+    emit sectionRemoved(name, id);
     saveQuestions();
     return true;
 }
 
 bool QuizManager::editSection(const QString &oldName, const QString &newName, const QString &questionsFile, const QString &answersFile)
 {
-    if (!m_sections.contains(oldName)) {
+    const SectionId id = sectionId(oldName);
+    if (id == InvalidSection) {
         qDebug() << "[ERROR] Section does not exist:" << oldName;
         return false;
     }
 
-    if (oldName != newName && m_sections.contains(newName)) {
+    if (oldName != newName && m_sectionIds.contains(newName)) {
         qDebug() << "[ERROR] Section with new name already exists:" << newName;
         return false;
     }
 
-    Section section = m_sections[oldName];
+    Section section = m_sections[id];
     section.name = newName;
     section.questionsFile = questionsFile;
     section.answersFile = answersFile;
 
-    if (!loadQuestionsFromFile(questionsFile, section.questions)) {
-        qDebug() << "[ERROR] Failed to load questions from file:" << questionsFile;
+    section.bank = QuestionBank::load(questionsFile, answersFile);
+    if (!section.bank) {
+        qDebug() << "[ERROR] Failed to load section files:" << questionsFile << answersFile;
         return false;
     }
 
-    if (!loadAnswersFromFile(answersFile, section.answers)) {
-        qDebug() << "[ERROR] Failed to load answers from file:" << answersFile;
-        return false;
-    }
-
-    if (section.questions.size() != section.answers.size()) {
-        qDebug() << "[ERROR] Questions and answers count mismatch for section:" << newName;
+    if (!section.bank->isValid()) {
+        qDebug() << "[ERROR] Questions and answers mismatch for section:" << newName;
         return false;
     }
 
+    // Номер раздела при переименовании сохраняется, меняется только запись в индексе имён
+    unwatchSection(id);
     if (oldName != newName) {
-        m_sections.remove(oldName);
+        m_sectionIds.remove(oldName);
+        m_sectionIds.insert(newName, id);
     }
-    m_sections[newName] = section;
+    releaseBank(m_sections[id]);
+    m_sections[id] = section;
+    watchSection(id);
+    touchSection(id);
+
+    // Обновляем тест и марафон, если отредактирован один из их разделов
+    updateSessions(id);
+    enforceMemoryBudget();
     emit sectionEdited(newName);
     saveQuestions();
     return true;
 }
 
+void QuizManager::adoptSectionBank(const QString& name, const QString& questionsFile, const QString& answersFile,
+                                   const QSharedPointer<const QuestionBank>& bank)
+{
+    const SectionId id = sectionId(name);
+    if (id == InvalidSection || !bank) {
+        return;
+    }
+    Section& section = m_sections[id];
+    // Раздел могли изменить, пока банк читался: чужая версия файлов не устанавливается
+    if (section.isLoaded() || section.questionsFile != questionsFile || section.answersFile != answersFile) {
+        return;
+    }
+    section.bank = bank;
+    watchSection(id);
+    touchSection(id);
+    LOG_INFO("Section loaded: " + name);
+    enforceMemoryBudget();
+}
+
 QStringList QuizManager::getSectionNames() const
 {
-    return m_sections.keys();
+    QStringList names = m_sectionIds.keys();
+    std::sort(names.begin(), names.end());
+    return names;
 }
 
 bool QuizManager::startSectionTest(const QString &sectionName)
 {
-    if (!m_sections.contains(sectionName)) {
+    const SectionId id = sectionId(sectionName);
+    if (id == InvalidSection) {
         LOG_ERROR("Section does not exist: " + sectionName);
         return false;
     }
 
-    const Section& section = m_sections[sectionName];
-    if (section.questions.isEmpty() || section.answers.isEmpty()) {
+    if (!loadSectionBodies({ id })) {
+        emit error(tr("Не удалось загрузить раздел: %1").arg(sectionName));
+        return false;
+    }
+
+    const Section& section = m_sections[id];
+    if (section.questionCount() == 0) {
         LOG_ERROR("Section has no questions or answers");
         return false;
     }
 
     LOG_INFO("Starting test for section: " + sectionName);
-    LOG_INFO("Questions count: " + QString::number(section.questions.size()));
-    LOG_INFO("Answers count: " + QString::number(section.answers.size()));
+    LOG_INFO("Questions count: " + QString::number(section.questionCount()));
 
-    m_currentSection = sectionName;
-    m_currentQuestionIndex = 0;
-    m_correctAnswers = 0;
+    const quint64 seed = m_shuffleSeed ? m_shuffleSeed : SessionRandom::newSeed();
+    m_test.reset(new QuizSession(QuizSession::Mode::Test, { { section.name, section.bank } },
+                                 seed, m_answerOptionCount));
+    m_currentSectionId = id;
     m_isTestActive = true;
+    enforceMemoryBudget();
 
-    LOG_INFO("Test started for section: " + sectionName);
+    LOG_INFO_KV("Test started", { { "section", sectionName }, { "seed", seed } });
     emit testStarted(sectionName);
-    emit questionChanged(m_currentQuestionIndex);
+    emit questionChanged(m_test->questionIndex());
 
     return true;
 }
@@ -184,33 +535,40 @@ bool QuizManager::startMarathon(const QStringList &sections)
         return false;
     }
 
+    QVector<SectionId> ids;
+    ids.reserve(sections.size());
     for (const QString &section : sections) {
-        if (!m_sections.contains(section)) {
+        const SectionId id = sectionId(section);
+        if (id == InvalidSection) {
             LOG_ERROR("Section does not exist: " + section);
             return false;
         }
+        ids.append(id);
     }
 
-    m_marathonSections = sections;
-    m_currentMarathonSectionIndex = 0;
-    m_currentMarathonSection = sections.first();
-    m_currentMarathonQuestionIndex = 0;
-    m_marathonCorrectAnswers = 0;
-    m_isMarathonActive = true;
-    m_marathonStatuses.clear();
+    if (!loadSectionBodies(ids)) {
+        emit error(tr("Не удалось загрузить разделы марафона"));
+        return false;
+    }
 
-    // Подсчитываем общее количество вопросов
-    int totalQuestions = 0;
-    for (const QString& name : sections) {
-        totalQuestions += m_sections[name].questions.size();
+    QVector<QuizSession::Part> parts;
+    parts.reserve(ids.size());
+    for (SectionId id : ids) {
+        parts.append({ m_sections[id].name, m_sections[id].bank });
     }
-    m_marathonStatuses.resize(totalQuestions);
 
-    LOG_INFO("Starting marathon with sections: " + sections.join(", "));
-    LOG_INFO("Total questions: " + QString::number(totalQuestions));
+    const quint64 seed = m_shuffleSeed ? m_shuffleSeed : SessionRandom::newSeed();
+    m_marathon.reset(new QuizSession(QuizSession::Mode::Marathon, parts, seed, m_answerOptionCount));
+    m_marathonSectionIds = ids;
+    m_marathonSections = QSet<SectionId>(ids.cbegin(), ids.cend());
+    m_isMarathonActive = true;
+    enforceMemoryBudget();
+
+    LOG_INFO_KV("Starting marathon", { { "sections", sections }, { "questions", m_marathon->totalQuestions() },
+                                       { "seed", seed } });
 
     emit marathonStarted();
-    emit questionChanged(m_currentMarathonQuestionIndex);
+    emit questionChanged(m_marathon->questionIndex());
     return true;
 }
 
@@ -220,9 +578,7 @@ bool QuizManager::checkAnswer(const QString &answer)
         return false;
     }
 
-    const Section& section = m_sections[m_currentSection];
-    bool correct = (answer == section.answers[m_currentQuestionIndex]);
-    updateQuestionStatus(correct);
+    bool correct = m_test->checkAnswer(answer);
     emit answerChecked(correct);
     return correct;
 }
@@ -233,10 +589,7 @@ bool QuizManager::checkMarathonAnswer(const QString& answer)
         return false;
     }
 
-    const Section& section = m_sections[m_currentMarathonSection];
-    QString correctAnswer = getCurrentMarathonAnswer();
-    bool correct = (answer == correctAnswer);
-    updateMarathonStatus(correct);
+    bool correct = m_marathon->checkAnswer(answer);
     emit answerChecked(correct);
     return correct;
 }
@@ -247,25 +600,36 @@ bool QuizManager::endTest()
         return false;
     }
 
-    const Section& section = m_sections[m_currentSection];
-    emit testEnded(m_currentSection, m_correctAnswers, section.questions.size());
+    emit testEnded(m_test->sectionName(), m_test->correctAnswers(), m_test->totalQuestions());
+    // Завершённая сессия не должна держать банк: иначе выгруженный раздел остаётся в памяти вне бюджета
     m_isTestActive = false;
+    m_test.reset();
+    enforceMemoryBudget();
     return true;
 }
 
+void QuizManager::endMarathon()
+{
+    // Итоги читаются обработчиками marathonEnded, поэтому сессия освобождается после сигнала
+    emit marathonEnded(m_marathon->correctAnswers(), m_marathon->totalQuestions());
+    m_isMarathonActive = false;
+    m_marathon.reset();
+    m_marathonSectionIds.clear();
+    m_marathonSections.clear();
+    enforceMemoryBudget();
+}
+
 bool QuizManager::nextQuestion()
 {
     if (!m_isTestActive) {
         return false;
     }
 
-    const Section& section = m_sections[m_currentSection];
-    if (m_currentQuestionIndex >= section.questions.size() - 1) {
+    if (!m_test->next()) {
         return false; // Не позволяем перейти к следующему вопросу на последнем
     }
 
-    ++m_currentQuestionIndex;
-    emit questionChanged(m_currentQuestionIndex);
+    emit questionChanged(m_test->questionIndex());
     return true;
 }
 
@@ -275,104 +639,57 @@ bool QuizManager::nextMarathonQuestion()
         return false;
     }
 
-    const Section& section = m_sections[m_currentMarathonSection];
-    if (m_currentMarathonQuestionIndex >= section.questions.size() - 1) {
-        // Если это последний вопрос в текущем разделе
-        if (m_currentMarathonSectionIndex >= m_marathonSections.size() - 1) {
-            // Если это последний раздел, завершаем марафон
-            emit marathonEnded(m_marathonCorrectAnswers, getTotalMarathonQuestions());
-            return false;
-        }
-        // Переходим к следующему разделу
-        ++m_currentMarathonSectionIndex;
-        m_currentMarathonSection = m_marathonSections[m_currentMarathonSectionIndex];
-        m_currentMarathonQuestionIndex = 0;
-    } else {
-        // Переходим к следующему вопросу в текущем разделе
-        ++m_currentMarathonQuestionIndex;
+    if (!m_marathon->next()) {
+        // Если это последний вопрос последнего раздела, завершаем марафон
+        endMarathon();
+        return false;
     }
 
-    LOG_INFO("Moving to next marathon question. Section: " + m_currentMarathonSection + 
-             ", Question index: " + QString::number(m_currentMarathonQuestionIndex));
-    emit questionChanged(m_currentMarathonQuestionIndex);
+    LOG_INFO_KV("Moving to next marathon question",
+                { { "section", m_marathon->sectionName() }, { "index", m_marathon->questionIndex() } });
+    emit questionChanged(m_marathon->questionIndex());
     return true;
 }
 
 bool QuizManager::previousQuestion()
 {
-    if (!m_isTestActive || m_currentQuestionIndex <= 0) {
+    if (!m_isTestActive || !m_test->previous()) {
         return false;
     }
 
-    --m_currentQuestionIndex;
-    emit questionChanged(m_currentQuestionIndex);
+    emit questionChanged(m_test->questionIndex());
     return true;
 }
 
 bool QuizManager::previousMarathonQuestion()
 {
-    if (!m_isMarathonActive) {
+    if (!m_isMarathonActive || !m_marathon->previous()) {
         return false;
     }
 
-    if (m_currentMarathonQuestionIndex > 0) {
-        // Если есть предыдущий вопрос в текущем разделе
-        --m_currentMarathonQuestionIndex;
-    } else if (m_currentMarathonSectionIndex > 0) {
-        // Если это первый вопрос, переходим к последнему вопросу предыдущего раздела
-        --m_currentMarathonSectionIndex;
-        m_currentMarathonSection = m_marathonSections[m_currentMarathonSectionIndex];
-        m_currentMarathonQuestionIndex = m_sections[m_currentMarathonSection].questions.size() - 1;
-    } else {
-        // Если это первый вопрос первого раздела, ничего не делаем
-        return false;
-    }
-
-    LOG_INFO("Moving to previous marathon question. Section: " + m_currentMarathonSection + 
-             ", Question index: " + QString::number(m_currentMarathonQuestionIndex));
-    emit questionChanged(m_currentMarathonQuestionIndex);
+    LOG_INFO_KV("Moving to previous marathon question",
+                { { "section", m_marathon->sectionName() }, { "index", m_marathon->questionIndex() } });
+    emit questionChanged(m_marathon->questionIndex());
     return true;
 }
 
 bool QuizManager::goToQuestion(int index)
 {
-    if (!m_isTestActive) {
+    if (!m_isTestActive || !m_test->goTo(index)) {
         return false;
     }
 
-    const Section& section = m_sections[m_currentSection];
-    if (index < 0 || index >= section.questions.size()) {
-        return false;
-    }
-
-    m_currentQuestionIndex = index;
-    emit questionChanged(m_currentQuestionIndex);
+    emit questionChanged(m_test->questionIndex());
     return true;
 }
 
 bool QuizManager::goToMarathonQuestion(int index)
 {
-    if (!m_isMarathonActive) {
+    if (!m_isMarathonActive || !m_marathon->goTo(index)) {
         return false;
     }
 
-    if (index < 0 || index >= getTotalMarathonQuestions()) {
-        return false;
-    }
-
-    int currentIndex = 0;
-    for (int i = 0; i < m_marathonSections.size(); ++i) {
-        const Section& section = m_sections[m_marathonSections[i]];
-        if (currentIndex + section.questions.size() > index) {
-            m_currentMarathonSectionIndex = i;
-            m_currentMarathonSection = m_marathonSections[i];
-            m_currentMarathonQuestionIndex = index - currentIndex;
-            break;
-        }
-        currentIndex += section.questions.size();
-    }
-
-    emit questionChanged(m_currentMarathonQuestionIndex);
+    emit questionChanged(m_marathon->questionIndex());
     return true;
 }
 
@@ -381,7 +698,7 @@ QString QuizManager::getCurrentQuestion() const
     if (!m_isTestActive) {
         return QString();
     }
-    return m_sections[m_currentSection].questions[m_currentQuestionIndex];
+    return m_test->questionText();
 }
 
 QString QuizManager::getCurrentMarathonQuestion() const
@@ -389,7 +706,7 @@ QString QuizManager::getCurrentMarathonQuestion() const
     if (!m_isMarathonActive) {
         return QString();
     }
-    return m_sections[m_currentMarathonSection].questions[m_currentMarathonQuestionIndex];
+    return m_marathon->questionText();
 }
 
 QString QuizManager::getCurrentAnswer() const
@@ -397,7 +714,7 @@ QString QuizManager::getCurrentAnswer() const
     if (!m_isTestActive) {
         return QString();
     }
-    return m_sections[m_currentSection].answers[m_currentQuestionIndex];
+    return m_test->correctAnswer();
 }
 
 QString QuizManager::getCurrentMarathonAnswer() const
@@ -405,20 +722,7 @@ QString QuizManager::getCurrentMarathonAnswer() const
     if (!m_isMarathonActive) {
         return QString();
     }
-    const Section& section = m_sections[m_currentMarathonSection];
-    
-    // Ищем ответ с маркером {ans} и правильным номером вопроса
-    for (const QString& answer : section.answers) {
-        if (answer.startsWith(QString::number(m_currentMarathonQuestionIndex + 1) + ".") && 
-            answer.contains("{ans}")) {
-            // Убираем номер вопроса, точку и маркер правильного ответа
-            QString cleanAnswer = answer.mid(2);
-            cleanAnswer = cleanAnswer.replace(" {ans}", "");
-            return cleanAnswer;
-        }
-    }
-    
-    return QString();
+    return m_marathon->correctAnswer();
 }
 
 QStringList QuizManager::getCurrentAnswers() const
@@ -426,29 +730,7 @@ QStringList QuizManager::getCurrentAnswers() const
     if (!m_isTestActive) {
         return QStringList();
     }
-    const Section& section = m_sections[m_currentSection];
-    QStringList answers;
-    answers.append(section.answers[m_currentQuestionIndex]);
-    
-    // Добавляем случайные неправильные ответы
-    QVector<int> usedIndices;
-    usedIndices.append(m_currentQuestionIndex);
-    
-    while (answers.size() < 4) {
-        int randomIndex = QRandomGenerator::global()->bounded(section.answers.size());
-        if (!usedIndices.contains(randomIndex)) {
-            answers.append(section.answers[randomIndex]);
-            usedIndices.append(randomIndex);
-        }
-    }
-    
-    // Перемешиваем ответы
-    for (int i = answers.size() - 1; i > 0; --i) {
-        int j = QRandomGenerator::global()->bounded(i + 1);
-        answers.swapItemsAt(i, j);
-    }
-    
-    return answers;
+    return m_test->answers();
 }
 
 QStringList QuizManager::getCurrentMarathonAnswers() const
@@ -456,42 +738,22 @@ QStringList QuizManager::getCurrentMarathonAnswers() const
     if (!m_isMarathonActive) {
         return QStringList();
     }
-    const Section& section = m_sections[m_currentMarathonSection];
-    QStringList answers;
-    
-    // Получаем все варианты ответов для текущего вопроса
-    for (int i = 0; i < section.answers.size(); ++i) {
-        QString answer = section.answers[i];
-        if (answer.startsWith(QString::number(m_currentMarathonQuestionIndex + 1) + ".")) {
-            // Убираем номер вопроса, точку и маркер правильного ответа
-            QString cleanAnswer = answer.mid(2);
-            cleanAnswer = cleanAnswer.replace(" {ans}", "");
-            answers.append(cleanAnswer);
-        }
-    }
-    
-    // Перемешиваем ответы
-    for (int i = answers.size() - 1; i > 0; --i) {
-        int j = QRandomGenerator::global()->bounded(i + 1);
-        answers.swapItemsAt(i, j);
-    }
-    
-    return answers;
+    return m_marathon->answers();
 }
 
 int QuizManager::getCorrectAnswers() const
 {
-    return m_correctAnswers;
+    return m_test ? m_test->correctAnswers() : 0;
 }
 
 int QuizManager::getMarathonCorrectAnswers() const
 {
-    return m_marathonCorrectAnswers;
+    return m_marathon ? m_marathon->correctAnswers() : 0;
 }
 
 int QuizManager::getCurrentQuestionIndex() const
 {
-    return m_currentQuestionIndex;
+    return m_test ? m_test->questionIndex() : 0;
 }
 
 int QuizManager::getCurrentMarathonQuestionIndex() const
@@ -500,11 +762,7 @@ int QuizManager::getCurrentMarathonQuestionIndex() const
         return -1;
     }
 
-    int index = 0;
-    for (int i = 0; i < m_currentMarathonSectionIndex; ++i) {
-        index += m_sections[m_marathonSections[i]].questions.size();
-    }
-    return index + m_currentMarathonQuestionIndex;
+    return m_marathon->globalIndex();
 }
 
 int QuizManager::getTotalQuestions() const
@@ -512,7 +770,7 @@ int QuizManager::getTotalQuestions() const
     if (!m_isTestActive) {
         return 0;
     }
-    return m_sections[m_currentSection].questions.size();
+    return m_test->totalQuestions();
 }
 
 int QuizManager::getTotalMarathonQuestions() const
@@ -521,145 +779,115 @@ int QuizManager::getTotalMarathonQuestions() const
         return 0;
     }
 
-    int total = 0;
-    for (const QString& name : m_marathonSections) {
-        total += m_sections[name].questions.size();
-    }
-    return total;
+    return m_marathon->totalQuestions();
 }
 
-QVector<int> QuizManager::getQuestionStatuses() const
+AnswerStatuses QuizManager::getQuestionStatuses() const
 {
-    return m_questionStatuses;
+    return m_test ? m_test->statuses() : AnswerStatuses();
 }
 
-QVector<int> QuizManager::getMarathonStatuses() const
+AnswerStatuses QuizManager::getMarathonStatuses() const
 {
-    return m_marathonStatuses;
+    return m_marathon ? m_marathon->statuses() : AnswerStatuses();
+}
+
+AnswerStatuses::Counts QuizManager::getMarathonCounts() const
+{
+    return m_marathon ? m_marathon->counts() : AnswerStatuses::Counts();
+}
+
+QVector<QuizManager::SectionScore> QuizManager::getMarathonSectionScores() const
+{
+    QVector<SectionScore> scores;
+    if (!m_marathon) {
+        return scores;
+    }
+    scores.reserve(m_marathon->partCount());
+    for (int part = 0; part < m_marathon->partCount(); ++part) {
+        scores.append({ m_marathon->partSection(part), m_marathon->partCounts(part) });
+    }
+    return scores;
 }
 
 void QuizManager::resetTest()
 {
-    m_currentQuestionIndex = 0;
-    m_correctAnswers = 0;
-    m_questionStatuses.clear();
+    if (m_test) {
+        m_test->reset();
+    }
     if (m_isTestActive) {
-        m_questionStatuses.resize(m_sections[m_currentSection].questions.size());
-        emit questionChanged(m_currentQuestionIndex);
+        emit questionChanged(m_test->questionIndex());
     }
 }
 
 void QuizManager::resetMarathon()
 {
-    m_currentMarathonSectionIndex = 0;
-    m_currentMarathonSection = m_marathonSections.first();
-    m_currentMarathonQuestionIndex = 0;
-    m_marathonCorrectAnswers = 0;
-    m_marathonStatuses.clear();
+    if (m_marathon) {
+        m_marathon->reset();
+    }
     if (m_isMarathonActive) {
-        int totalQuestions = 0;
-        for (const QString& name : m_marathonSections) {
-            totalQuestions += m_sections[name].questions.size();
-        }
-        m_marathonStatuses.resize(totalQuestions);
-        emit questionChanged(m_currentMarathonQuestionIndex);
+        emit questionChanged(m_marathon->questionIndex());
     }
 }
 
 QString QuizManager::getCurrentSectionName() const
 {
-    return m_currentSection;
+    return m_test ? m_test->sectionName() : QString();
 }
 
 QString QuizManager::getCurrentMarathonSectionName() const
 {
-    return m_currentMarathonSection;
+    return m_marathon ? m_marathon->sectionName() : QString();
 }
 
 int QuizManager::getCurrentSectionQuestionCount() const
 {
-    if (m_currentSection.isEmpty()) {
-        return 0;
-    }
-    return m_sections[m_currentSection].questions.size();
+    return m_test ? m_test->sectionQuestionCount() : 0;
 }
 
 int QuizManager::getCurrentMarathonSectionQuestionCount() const
 {
-    if (m_currentMarathonSection.isEmpty()) {
+    if (!m_isMarathonActive) {
         return 0;
     }
-    return m_sections[m_currentMarathonSection].questions.size();
+    return m_marathon->sectionQuestionCount();
 }
 
-void QuizManager::updateQuestionStatus(bool correct)
+void QuizManager::updateSessions(SectionId id)
 {
-    if (correct) {
-        ++m_correctAnswers;
+    // Сессии держат собственные ссылки на банки, поэтому новая версия раздела передаётся им явно
+    const Section& section = m_sections[id];
+    if (m_isTestActive && m_currentSectionId == id) {
+        m_test->replacePart(0, { section.name, section.bank });
+        emit questionChanged(m_test->questionIndex());
     }
-    m_questionStatuses[m_currentQuestionIndex] = correct ? 1 : -1;
-}
-
-void QuizManager::updateMarathonStatus(bool correct)
-{
-    int globalIndex = getCurrentMarathonQuestionIndex();
-    // Если вопрос еще не был отвечен (статус 0) и ответ правильный
-    if (m_marathonStatuses[globalIndex] == 0 && correct) {
-        ++m_marathonCorrectAnswers;
-    }
-    m_marathonStatuses[globalIndex] = correct ? 1 : -1;
-}
-
-bool QuizManager::loadQuestionsFromFile(const QString& filePath, QVector<QString>& questions)
-{
-    QFile file(filePath);
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        LOG_ERROR("Failed to open questions file: " + filePath);
-        return false;
-    }
-
-    questions.clear();
-    while (!file.atEnd()) {
-        QString line = QString::fromUtf8(file.readLine()).trimmed();
-        if (!line.isEmpty()) {
-            questions.append(line);
+    if (m_isMarathonActive) {
+        bool changed = false;
+        for (int part = 0; part < m_marathonSectionIds.size(); ++part) {
+            if (m_marathonSectionIds[part] == id) {
+                m_marathon->replacePart(part, { section.name, section.bank });
+                changed = true;
+            }
         }
-    }
-
-    LOG_INFO("Loaded " + QString::number(questions.size()) + " questions from " + filePath);
-    file.close();
-    return true;
-}
-
-bool QuizManager::loadAnswersFromFile(const QString& filePath, QVector<QString>& answers)
-{
-    QFile file(filePath);
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        LOG_ERROR("Failed to open answers file: " + filePath);
-        return false;
-    }
-
-    answers.clear();
-    while (!file.atEnd()) {
-        QString line = QString::fromUtf8(file.readLine()).trimmed();
-        if (!line.isEmpty()) {
-            answers.append(line);
+        if (changed) {
+            emit questionChanged(m_marathon->questionIndex());
         }
     }
-
-    LOG_INFO("Loaded " + QString::number(answers.size()) + " answers from " + filePath);
-    file.close();
-    return true;
 }
 
 bool QuizManager::saveQuestions()
 {
+    METRICS_SCOPED_TIMER("quizown_save_questions_seconds", "Saving the sections catalog");
+
     QJsonObject obj;
-    for (auto it = m_sections.constBegin(); it != m_sections.constEnd(); ++it) {
+    for (const Section& section : m_sections) {
+        if (!section.isValid()) {
+            continue;
+        }
         QJsonObject sectionObj;
-        sectionObj["questionsFile"] = it.value().questionsFile;
-        sectionObj["answersFile"] = it.value().answersFile;
-        obj[it.key()] = sectionObj;
+        sectionObj["questionsFile"] = section.questionsFile;
+        sectionObj["answersFile"] = section.answersFile;
+        obj[section.name] = sectionObj;
     }
 
     QJsonDocument doc(obj);
@@ -676,29 +904,27 @@ bool QuizManager::saveQuestions()
 
 QString QuizManager::getSectionQuestionsFile(const QString& name) const
 {
-    if (!m_sections.contains(name)) {
+    const SectionId id = sectionId(name);
+    if (id == InvalidSection) {
         return QString();
     }
-    return m_sections[name].questionsFile;
+    return m_sections[id].questionsFile;
 }
 
 QString QuizManager::getSectionAnswersFile(const QString& name) const
 {
-    if (!m_sections.contains(name)) {
+    const SectionId id = sectionId(name);
+    if (id == InvalidSection) {
         return QString();
     }
-    return m_sections[name].answersFile;
+    return m_sections[id].answersFile;
 }
 
 const QuizManager::Section& QuizManager::getCurrentSection() const
 {
     static Section emptySection;
-    if (!m_isTestActive || m_currentSection.isEmpty()) {
-        return emptySection;
-    }
-    auto it = m_sections.find(m_currentSection);
-    if (it == m_sections.end()) {
+    if (!m_isTestActive || m_currentSectionId == InvalidSection) {
         return emptySection;
     }
-    return it.value();
+    return m_sections[m_currentSectionId];
 } 
\ No newline at end of file
@@ -1,5 +0,0 @@
-bool nextQuestion();
-bool previousQuestion();
-bool goToQuestion(int index);
-bool endTest();
-QString getCurrentQuestion() const; 
\ No newline at end of file
@@ -1,6 +1,7 @@
 #include "quizsection.h"
 #include "logger.h"
 #include <QRegularExpression>
+#include "lineparser.h"
 
 QuizSection::QuizSection(const QString& name, QObject *parent)
     : QObject(parent)
@@ -36,9 +37,12 @@ bool QuizSection::loadFromFiles(const QString& questionsFile, const QString& ans
     }
     
     m_questions.clear();
+    m_pool.clear();
+    m_questions.reserve(questions.size());
     for (int i = 0; i < questions.size(); ++i) {
-        m_questions.append(qMakePair(questions[i], answers[i]));
+        m_questions.append(qMakePair(m_pool.intern(questions[i]), m_pool.intern(answers[i])));
     }
+    m_pool.squeeze();
     
     LOG_INFO(QString("Successfully loaded %1 questions for section '%2'")
              .arg(m_questions.size())
@@ -56,9 +60,14 @@ bool QuizSection::saveToFiles(const QString& questionsFile, const QString& answe
     QVector<QString> questions;
     QVector<QString> answers;
     
+    // Сохранение - естественная точка, чтобы избавиться от текста старых правок
+    compactPool();
+
+    questions.reserve(m_questions.size());
+    answers.reserve(m_questions.size());
     for (const auto& pair : m_questions) {
-        questions.append(pair.first);
-        answers.append(pair.second);
+        questions.append(m_pool.string(pair.first));
+        answers.append(m_pool.string(pair.second));
     }
     
     if (!writeFile(questionsFile, questions) || !writeFile(answersFile, answers)) {
@@ -98,7 +107,7 @@ QString QuizSection::getQuestion(int index) const
     if (!validateIndex(index)) {
         return QString();
     }
-    return m_questions[index].first;
+    return m_pool.string(m_questions[index].first);
 }
 
 QString QuizSection::getAnswer(int index) const
@@ -106,7 +115,7 @@ QString QuizSection::getAnswer(int index) const
     if (!validateIndex(index)) {
         return QString();
     }
-    return m_questions[index].second;
+    return m_pool.string(m_questions[index].second);
 }
 
 bool QuizSection::setQuestion(int index, const QString& question)
@@ -115,8 +124,9 @@ bool QuizSection::setQuestion(int index, const QString& question)
         return false;
     }
     
-    if (m_questions[index].first != question) {
-        m_questions[index].first = question;
+    if (m_pool.view(m_questions[index].first) != question) {
+        m_questions[index].first = m_pool.intern(question);
+        compactPoolIfSparse();
         emit questionsChanged();
         LOG_DEBUG(QString("Updated question %1 in section '%2'")
                  .arg(index + 1)
@@ -132,8 +142,9 @@ bool QuizSection::setAnswer(int index, const QString& answer)
         return false;
     }
     
-    if (m_questions[index].second != answer) {
-        m_questions[index].second = answer;
+    if (m_pool.view(m_questions[index].second) != answer) {
+        m_questions[index].second = m_pool.intern(answer);
+        compactPoolIfSparse();
         emit questionsChanged();
         LOG_DEBUG(QString("Updated answer %1 in section '%2'")
                  .arg(index + 1)
@@ -145,7 +156,8 @@ bool QuizSection::setAnswer(int index, const QString& answer)
 
 bool QuizSection::addQuestion(const QString& question, const QString& answer)
 {
-    m_questions.append(qMakePair(question, answer));
+    m_questions.append(qMakePair(m_pool.intern(question), m_pool.intern(answer)));
+    compactPoolIfSparse();
     emit questionsChanged();
     LOG_DEBUG(QString("Added new question to section '%1' (total: %2)")
              .arg(m_name)
@@ -160,6 +172,7 @@ bool QuizSection::removeQuestion(int index)
     }
     
     m_questions.removeAt(index);
+    compactPoolIfSparse();
     emit questionsChanged();
     LOG_DEBUG(QString("Removed question %1 from section '%2' (total: %3)")
              .arg(index + 1)
@@ -171,6 +184,7 @@ bool QuizSection::removeQuestion(int index)
 void QuizSection::clear()
 {
     m_questions.clear();
+    m_pool.clear();
     emit questionsChanged();
     LOG_INFO(QString("Cleared all questions from section '%1'").arg(m_name));
 }
@@ -180,22 +194,54 @@ bool QuizSection::validateIndex(int index) const
     return index >= 0 && index < m_questions.size();
 }
 
+void QuizSection::compactPool()
+{
+    // Переносим в новый пул только строки, на которые ещё ссылаются вопросы
+    StringPool pool;
+    pool.reserve(m_questions.size() * 2, 0);
+    for (auto& pair : m_questions) {
+        pair.first = pool.intern(m_pool.view(pair.first));
+        pair.second = pool.intern(m_pool.view(pair.second));
+    }
+    pool.squeeze();
+    m_pool = std::move(pool);
+}
+
+void QuizSection::compactPoolIfSparse()
+{
+    // Пул только дополняется, и каждая правка оставляет в нём прежний текст. Перестраиваем его,
+    // когда записей стало вдвое больше, чем строк у вопросов: перестройка окупается правками
+    const qsizetype liveStrings = qsizetype(m_questions.size()) * 2;
+    if (m_pool.size() > 2 * liveStrings + 64) {
+        compactPool();
+    }
+}
+
 bool QuizSection::readFile(const QString& filename, QVector<QString>& lines)
 {
     QFile file(filename);
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+    if (!file.open(QIODevice::ReadOnly)) {
         LOG_ERROR(QString("Failed to open file: %1").arg(filename));
         return false;
     }
     
-    QTextStream in(&file);
+    LineReader reader(&file);
+    QByteArrayView line;
     lines.clear();
     
-    while (!in.atEnd()) {
-        QString line = in.readLine().trimmed();
-        if (!line.isEmpty()) {
-            lines.append(line);
-        }
+    while (reader.next(line)) {
+        lines.append(QString::fromUtf8(line));
+    }
+    
+    // Иначе усечённый файл загрузился бы как полный
+    if (reader.hasError()) {
+        LOG_ERROR(QString("Failed to read file: %1: %2").arg(filename, file.errorString()));
+        lines.clear();
+        return false;
+    }
+    
+    if (reader.hasInvalidUtf8()) {
+        LOG_WARNING(QString("File is not valid UTF-8: %1").arg(filename));
     }
     
     file.close();
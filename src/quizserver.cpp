@@ -0,0 +1,704 @@
+#include "quizserver.h"
+#include "quizmanager.h"
+#include "sessionrandom.h"
+#include "logger.h"
+#include "metrics.h"
+#include <QCryptographicHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QMessageAuthenticationCode>
+#include <QTcpSocket>
+#include <QThread>
+#include <QtEndian>
+#include <algorithm>
+
+namespace {
+
+const qsizetype kMaxHeaderSize = 16 * 1024;
+const qsizetype kMaxBodySize = 1024 * 1024;
+const int kSessionLockCount = 64;
+
+// Минимальная страница для кандидата: работает через тот же HTTP API
+const char kIndexPage[] = R"HTML(<!DOCTYPE html>
+<html><head><meta charset="utf-8"><title>QuizOwn</title>
+<style>body{font-family:sans-serif;max-width:720px;margin:2em auto}button{margin:4px}
+.ok{background:#4CAF50;color:#fff}.bad{background:#F44336;color:#fff}</style></head>
+<body><h1>QuizOwn</h1>
+<div id="start"><select id="sections"></select><button onclick="start()">Начать</button></div>
+<div id="quiz" hidden><p id="progress"></p><h3 id="question"></h3><div id="answers"></div>
+<button onclick="call('previous')">&larr;</button><button onclick="call('next')">&rarr;</button></div>
+<script>
+let token = null;
+async function api(method, path, body) {
+  const response = await fetch(path, { method, headers: { 'Content-Type': 'application/json' },
+                                       body: body ? JSON.stringify(body) : undefined });
+  return response.json();
+}
+function show(state) {
+  if (state.error) { alert(state.error); return; }
+  token = state.session;
+  document.getElementById('start').hidden = true;
+  document.getElementById('quiz').hidden = false;
+  document.getElementById('progress').textContent =
+    state.section + ': ' + (state.index + 1) + ' / ' + state.total + ', верно ' + state.correctAnswers;
+  document.getElementById('question').textContent = state.question;
+  const answers = document.getElementById('answers');
+  answers.innerHTML = '';
+  for (const text of state.answers) {
+    const button = document.createElement('button');
+    button.textContent = text;
+    button.onclick = async () => {
+      const result = await api('POST', '/api/sessions/' + token + '/check', { answer: text });
+      button.className = result.correct ? 'ok' : 'bad';
+    };
+    answers.appendChild(document.createElement('div')).appendChild(button);
+  }
+}
+async function start() {
+  show(await api('POST', '/api/sessions', { sections: [document.getElementById('sections').value] }));
+}
+async function call(op) { show(await api('POST', '/api/sessions/' + token + '/' + op)); }
+api('GET', '/api/sections').then(result => {
+  for (const name of result.sections) {
+    document.getElementById('sections').add(new Option(name, name));
+  }
+});
+</script></body></html>
+)HTML";
+
+QByteArray statusText(int status)
+{
+    switch (status) {
+    case 101: return "Switching Protocols";
+    case 200: return "OK";
+    case 201: return "Created";
+    case 400: return "Bad Request";
+    case 404: return "Not Found";
+    case 405: return "Method Not Allowed";
+    case 413: return "Payload Too Large";
+    case 503: return "Service Unavailable";
+    default: return "Internal Server Error";
+    }
+}
+
+QJsonObject errorObject(const QString& message)
+{
+    QJsonObject object;
+    object["error"] = message;
+    return object;
+}
+
+QMutex& sessionLock(SessionPool::SessionId id)
+{
+    // Блокировки распределены по номеру сессии: запросы одной сессии из разных
+    // соединений выполняются по очереди, разные сессии почти не пересекаются
+    static QMutex locks[kSessionLockCount];
+    return locks[id % kSessionLockCount];
+}
+
+// Время сравнения не зависит от позиции первого расхождения, поэтому подпись токена нельзя подбирать по байту
+bool constantTimeEquals(const QByteArray& a, const QByteArray& b)
+{
+    if (a.size() != b.size()) {
+        return false;
+    }
+    uchar diff = 0;
+    for (qsizetype i = 0; i < a.size(); ++i) {
+        diff |= uchar(a[i]) ^ uchar(b[i]);
+    }
+    return diff == 0;
+}
+
+} // namespace
+
+ServerState::ServerState()
+    : m_catalog(new ServerCatalog)
+    , m_tokenKey(QByteArray::number(SessionRandom::newSeed(), 16) + QByteArray::number(SessionRandom::newSeed(), 16))
+{
+}
+
+void ServerState::setCatalog(const QSharedPointer<const ServerCatalog>& catalog)
+{
+    // Разделы могли быть перезагружены: новые сессии берут банки у менеджера заново
+    QMutexLocker locker(&m_catalogMutex);
+    m_catalog = catalog;
+    m_banks.clear();
+    ++m_catalogGeneration;
+}
+
+QSharedPointer<const ServerCatalog> ServerState::catalog() const
+{
+    QMutexLocker locker(&m_catalogMutex);
+    return m_catalog;
+}
+
+QSharedPointer<const QuestionBank> ServerState::bank(const QString& name)
+{
+    ServerCatalog::Section files;
+    quint64 generation;
+    {
+        QMutexLocker locker(&m_catalogMutex);
+        while (m_loadingBanks.contains(name)) {
+            m_bankLoaded.wait(&m_catalogMutex);
+        }
+        const auto it = m_catalog->sections.constFind(name);
+        if (it == m_catalog->sections.constEnd()) {
+            return QSharedPointer<const QuestionBank>();
+        }
+        const QSharedPointer<const QuestionBank> cached = m_banks.value(name).toStrongRef();
+        if (cached) {
+            return cached;
+        }
+        files = *it;
+        generation = m_catalogGeneration;
+        m_loadingBanks.insert(name);
+    }
+
+    // QuestionBank::load потокобезопасен: первые start разных разделов читают файлы параллельно,
+    // не проходя через главный поток
+    QSharedPointer<const QuestionBank> loaded = QuestionBank::load(files.questionsFile, files.answersFile);
+    if (!loaded) {
+        LOG_ERROR("Failed to load section: " + name);
+    } else if (!loaded->isValid()) {
+        LOG_ERROR("Questions and answers mismatch for section: " + name);
+        loaded.reset();
+    }
+
+    {
+        QMutexLocker locker(&m_catalogMutex);
+        m_loadingBanks.remove(name);
+        if (loaded && generation == m_catalogGeneration) {
+            m_banks.insert(name, loaded);
+        }
+        m_bankLoaded.wakeAll();
+    }
+    if (loaded && m_bankLoadedHandler) {
+        m_bankLoadedHandler(name, files, loaded);
+    }
+    return loaded;
+}
+
+QString ServerState::makeToken(SessionPool::SessionId id) const
+{
+    // Токен = номер сессии + подпись HMAC, поэтому серверу не нужно хранить секреты сессий
+    const QByteArray number = QByteArray::number(id);
+    const QByteArray tag = QMessageAuthenticationCode::hash(number, m_tokenKey, QCryptographicHash::Sha256);
+    return QString::fromLatin1(number + '-' + tag.left(12).toHex());
+}
+
+QSharedPointer<QuizSession> ServerState::findSession(const QString& token, SessionPool::SessionId* id) const
+{
+    const qsizetype dash = token.indexOf('-');
+    bool ok = false;
+    const SessionPool::SessionId number = token.left(dash).toULongLong(&ok);
+    if (dash <= 0 || !ok || !constantTimeEquals(makeToken(number).toLatin1(), token.toLatin1())) {
+        return QSharedPointer<QuizSession>();
+    }
+    *id = number;
+    return m_sessions.find(number);
+}
+
+QJsonObject ServerState::sessionState(const QString& token, const QuizSession& session) const
+{
+    QJsonObject state;
+    state["session"] = token;
+    state["mode"] = session.mode() == QuizSession::Mode::Test ? "test" : "marathon";
+    state["section"] = session.sectionName();
+    state["index"] = session.globalIndex();
+    state["total"] = session.totalQuestions();
+    state["question"] = session.questionText();
+    state["answers"] = QJsonArray::fromStringList(session.answers());
+    const AnswerStatuses::Counts counts = session.counts();
+    state["correctAnswers"] = counts.correct;
+    state["wrongAnswers"] = counts.wrong;
+    state["unanswered"] = counts.unanswered;
+    return state;
+}
+
+QJsonObject ServerState::handle(const QString& op, const QJsonObject& args, QString& token, int* status)
+{
+    *status = 200;
+
+    if (op == "sections") {
+        QStringList names = catalog()->sections.keys();
+        std::sort(names.begin(), names.end());
+        QJsonObject result;
+        result["sections"] = QJsonArray::fromStringList(names);
+        return result;
+    }
+
+    if (op == "start") {
+        QStringList names;
+        for (const QJsonValue& value : args["sections"].toArray()) {
+            names.append(value.toString());
+        }
+        if (args["section"].isString()) {
+            names.append(args["section"].toString());
+        }
+        if (names.isEmpty()) {
+            *status = 400;
+            return errorObject("No sections given");
+        }
+
+        const QSharedPointer<const ServerCatalog> snapshot = catalog();
+        QVector<QuizSession::Part> parts;
+        for (const QString& name : names) {
+            if (!snapshot->sections.contains(name)) {
+                *status = 404;
+                return errorObject("Section does not exist: " + name);
+            }
+            const QSharedPointer<const QuestionBank> sectionBank = bank(name);
+            if (!sectionBank) {
+                *status = 500;
+                return errorObject("Failed to load section: " + name);
+            }
+            parts.append({ name, sectionBank });
+        }
+
+        const QString mode = args["mode"].toString(names.size() == 1 ? "test" : "marathon");
+        const quint64 seed = args["seed"].isString() ? args["seed"].toString().toULongLong()
+                                                     : quint64(args["seed"].toInteger());
+        const SessionPool::SessionId id = m_sessions.create(
+            mode == "marathon" ? QuizSession::Mode::Marathon : QuizSession::Mode::Test,
+            parts, seed, snapshot->answerOptionCount);
+        if (id == SessionPool::InvalidSession) {
+            *status = 503;
+            return errorObject("Too many active sessions");
+        }
+        token = makeToken(id);
+
+        *status = 201;
+        const QSharedPointer<QuizSession> session = m_sessions.find(id);
+        QMutexLocker locker(&sessionLock(id));
+        return sessionState(token, *session);
+    }
+
+    SessionPool::SessionId id = 0;
+    const QSharedPointer<QuizSession> session = findSession(token, &id);
+    if (!session) {
+        *status = 404;
+        return errorObject("Unknown session");
+    }
+
+    if (op == "end") {
+        m_sessions.remove(id);
+        token.clear();
+        QJsonObject result;
+        result["ended"] = true;
+        return result;
+    }
+
+    QMutexLocker locker(&sessionLock(id));
+    bool moved = true;
+    bool correct = false;
+    if (op == "next") {
+        moved = session->next();
+    } else if (op == "previous") {
+        moved = session->previous();
+    } else if (op == "goto") {
+        moved = session->goTo(args["index"].toInt(-1));
+    } else if (op == "check") {
+        correct = session->checkAnswer(args["answer"].toString());
+    } else if (op != "state") {
+        *status = 400;
+        return errorObject("Unknown operation: " + op);
+    }
+
+    QJsonObject state = sessionState(token, *session);
+    state["moved"] = moved;
+    if (op == "check") {
+        state["correct"] = correct;
+    }
+    return state;
+}
+
+ServerConnection::ServerConnection(qintptr socketDescriptor, ServerState* state, QObject* parent)
+    : QObject(parent)
+    , m_socket(new QTcpSocket(this))
+    , m_state(state)
+{
+    if (!m_socket->setSocketDescriptor(socketDescriptor)) {
+        LOG_WARNING("Failed to accept connection: " + m_socket->errorString());
+        deleteLater();
+        return;
+    }
+    // Ответы маленькие, поэтому отключаем алгоритм Нейгла ради задержки
+    m_socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+    connect(m_socket, &QTcpSocket::readyRead, this, &ServerConnection::onReadyRead);
+    connect(m_socket, &QTcpSocket::disconnected, this, &QObject::deleteLater);
+}
+
+void ServerConnection::onReadyRead()
+{
+    m_buffer.append(m_socket->readAll());
+    // Обрабатываем все полные запросы в буфере (конвейерные HTTP-запросы и пачки кадров)
+    while (m_webSocket ? processWebSocket() : processHttp()) {
+    }
+}
+
+bool ServerConnection::processHttp()
+{
+    const qsizetype headerEnd = m_buffer.indexOf("\r\n\r\n");
+    if (headerEnd < 0) {
+        if (m_buffer.size() > kMaxHeaderSize) {
+            closeWithError(413);
+        }
+        return false;
+    }
+
+    const QList<QByteArray> lines = m_buffer.left(headerEnd).split('\n');
+    const QList<QByteArray> requestLine = lines.first().trimmed().split(' ');
+    if (requestLine.size() != 3) {
+        closeWithError(400);
+        return false;
+    }
+
+    QHash<QByteArray, QByteArray> headers;
+    for (int i = 1; i < lines.size(); ++i) {
+        const qsizetype colon = lines[i].indexOf(':');
+        if (colon > 0) {
+            headers.insert(lines[i].left(colon).trimmed().toLower(), lines[i].mid(colon + 1).trimmed());
+        }
+    }
+
+    const qsizetype contentLength = headers.value("content-length", "0").toLongLong();
+    if (contentLength < 0 || contentLength > kMaxBodySize) {
+        closeWithError(413);
+        return false;
+    }
+    if (m_buffer.size() < headerEnd + 4 + contentLength) {
+        return false;
+    }
+
+    const QByteArray body = m_buffer.mid(headerEnd + 4, contentLength);
+    m_buffer.remove(0, headerEnd + 4 + contentLength);
+
+    const QByteArray connection = headers.value("connection").toLower();
+    m_keepAlive = requestLine[2] == "HTTP/1.1" ? !connection.contains("close") : connection.contains("keep-alive");
+
+    if (headers.value("upgrade").toLower() == "websocket") {
+        upgradeToWebSocket(headers);
+        return m_webSocket;
+    }
+
+    handleHttpRequest(requestLine[0], requestLine[1], headers, body);
+    return m_keepAlive && m_socket->state() == QAbstractSocket::ConnectedState;
+}
+
+void ServerConnection::handleHttpRequest(const QByteArray& method, const QByteArray& path,
+                                         const QHash<QByteArray, QByteArray>& headers, const QByteArray& body)
+{
+    Q_UNUSED(headers)
+
+    METRICS_SCOPED_TIMER("quizown_server_request_seconds", "Handling an HTTP request in the quiz server");
+
+    if (method == "GET" && (path == "/" || path == "/index.html")) {
+        sendHttp(200, "text/html; charset=utf-8", QByteArray(kIndexPage));
+        return;
+    }
+    if (method == "GET" && path == "/metrics" && m_state->isMetricsEnabled()) {
+        sendHttp(200, "text/plain; version=0.0.4", Metrics::instance().toPrometheus());
+        return;
+    }
+
+    // /api/sections, /api/sessions, /api/sessions/<token>[/<op>]
+    const QList<QByteArray> parts = path.split('?').first().split('/');
+    QString op;
+    QString token;
+    if (parts.size() == 3 && parts[1] == "api" && parts[2] == "sections" && method == "GET") {
+        op = "sections";
+    } else if (parts.size() == 3 && parts[1] == "api" && parts[2] == "sessions" && method == "POST") {
+        op = "start";
+    } else if (parts.size() >= 4 && parts[1] == "api" && parts[2] == "sessions") {
+        token = QString::fromLatin1(parts[3]);
+        if (parts.size() == 4) {
+            op = method == "DELETE" ? "end" : method == "GET" ? "state" : QString();
+        } else if (parts.size() == 5 && method == "POST") {
+            op = QString::fromLatin1(parts[4]);
+        }
+    }
+    if (op.isEmpty()) {
+        sendHttp(404, "application/json", QJsonDocument(errorObject("Not found")).toJson(QJsonDocument::Compact));
+        return;
+    }
+
+    QJsonObject args;
+    if (!body.isEmpty()) {
+        QJsonParseError error;
+        const QJsonDocument document = QJsonDocument::fromJson(body, &error);
+        if (error.error != QJsonParseError::NoError || !document.isObject()) {
+            sendHttp(400, "application/json",
+                     QJsonDocument(errorObject("Invalid JSON body")).toJson(QJsonDocument::Compact));
+            return;
+        }
+        args = document.object();
+    }
+
+    int status = 200;
+    const QJsonObject result = m_state->handle(op, args, token, &status);
+    sendHttp(status, "application/json", QJsonDocument(result).toJson(QJsonDocument::Compact));
+}
+
+void ServerConnection::sendHttp(int status, const QByteArray& contentType, const QByteArray& body)
+{
+    QByteArray response;
+    response.reserve(body.size() + 160);
+    response += "HTTP/1.1 " + QByteArray::number(status) + ' ' + statusText(status) + "\r\n";
+    response += "Content-Type: " + contentType + "\r\n";
+    response += "Content-Length: " + QByteArray::number(body.size()) + "\r\n";
+    response += m_keepAlive ? "Connection: keep-alive\r\n\r\n" : "Connection: close\r\n\r\n";
+    response += body;
+    m_socket->write(response);
+    if (!m_keepAlive) {
+        m_socket->disconnectFromHost();
+    }
+}
+
+void ServerConnection::closeWithError(int status)
+{
+    m_keepAlive = false;
+    sendHttp(status, "application/json", QJsonDocument(errorObject(QString::fromLatin1(statusText(status))))
+                                              .toJson(QJsonDocument::Compact));
+    m_buffer.clear();
+}
+
+void ServerConnection::upgradeToWebSocket(const QHash<QByteArray, QByteArray>& headers)
+{
+    const QByteArray key = headers.value("sec-websocket-key");
+    if (key.isEmpty() || headers.value("sec-websocket-version") != "13") {
+        closeWithError(400);
+        return;
+    }
+
+    // RFC 6455: ответный ключ = base64(SHA-1(ключ клиента + GUID))
+    const QByteArray accept = QCryptographicHash::hash(key + "258EAFA5-E914-47DA-95CA-C5AB0DC85B11",
+                                                       QCryptographicHash::Sha1).toBase64();
+    m_socket->write("HTTP/1.1 101 Switching Protocols\r\n"
+                    "Upgrade: websocket\r\n"
+                    "Connection: Upgrade\r\n"
+                    "Sec-WebSocket-Accept: " + accept + "\r\n\r\n");
+    m_webSocket = true;
+}
+
+bool ServerConnection::processWebSocket()
+{
+    if (m_buffer.size() < 2) {
+        return false;
+    }
+
+    const uchar* data = reinterpret_cast<const uchar*>(m_buffer.constData());
+    const bool isFinal = data[0] & 0x80;
+    const quint8 opcode = data[0] & 0x0F;
+    const bool masked = data[1] & 0x80;
+    quint64 length = data[1] & 0x7F;
+    qsizetype offset = 2;
+    if (length == 126) {
+        if (m_buffer.size() < 4) {
+            return false;
+        }
+        length = qFromBigEndian<quint16>(data + 2);
+        offset = 4;
+    } else if (length == 127) {
+        if (m_buffer.size() < 10) {
+            return false;
+        }
+        length = qFromBigEndian<quint64>(data + 2);
+        offset = 10;
+    }
+
+    // Кадры клиента обязаны быть замаскированы
+    if (!masked || length > quint64(kMaxBodySize)) {
+        sendFrame(0x8, QByteArray());
+        m_socket->disconnectFromHost();
+        m_buffer.clear();
+        return false;
+    }
+    if (quint64(m_buffer.size()) < quint64(offset) + 4 + length) {
+        return false;
+    }
+
+    const uchar* mask = data + offset;
+    QByteArray payload(m_buffer.constData() + offset + 4, qsizetype(length));
+    for (qsizetype i = 0; i < payload.size(); ++i) {
+        payload[i] = char(payload[i] ^ mask[i % 4]);
+    }
+    m_buffer.remove(0, offset + 4 + qsizetype(length));
+
+    switch (opcode) {
+    case 0x8:
+        sendFrame(0x8, payload.left(2));
+        m_socket->disconnectFromHost();
+        return false;
+    case 0x9:
+        sendFrame(0xA, payload);
+        return true;
+    case 0xA:
+        return true;
+    case 0x0:
+    case 0x1:
+        break;
+    default:
+        sendFrame(0x8, QByteArray());
+        m_socket->disconnectFromHost();
+        return false;
+    }
+
+    // Размер собранного сообщения ограничен так же, как тело HTTP-запроса: 1009 - сообщение слишком велико
+    if (m_fragments.size() + payload.size() > kMaxBodySize) {
+        QByteArray code(2, Qt::Uninitialized);
+        qToBigEndian<quint16>(1009, code.data());
+        sendFrame(0x8, code);
+        m_socket->disconnectFromHost();
+        m_buffer.clear();
+        m_fragments.clear();
+        return false;
+    }
+    m_fragments.append(payload);
+    if (!isFinal) {
+        return true;
+    }
+    const QByteArray message = m_fragments;
+    m_fragments.clear();
+
+    // Сообщение: {"op": "start|state|next|previous|goto|check|end|sections", ...}
+    const QJsonObject args = QJsonDocument::fromJson(message).object();
+    if (args["session"].isString()) {
+        m_token = args["session"].toString();
+    }
+    int status = 200;
+    QJsonObject result = m_state->handle(args["op"].toString(), args, m_token, &status);
+    result["op"] = args["op"];
+    result["status"] = status;
+    sendFrame(0x1, QJsonDocument(result).toJson(QJsonDocument::Compact));
+    return true;
+}
+
+void ServerConnection::sendFrame(quint8 opcode, const QByteArray& payload)
+{
+    QByteArray frame;
+    frame.reserve(payload.size() + 10);
+    frame.append(char(0x80 | opcode));
+    if (payload.size() < 126) {
+        frame.append(char(payload.size()));
+    } else if (payload.size() <= 0xFFFF) {
+        frame.append(char(126));
+        frame.append(char(payload.size() >> 8));
+        frame.append(char(payload.size() & 0xFF));
+    } else {
+        frame.append(char(127));
+        for (int shift = 56; shift >= 0; shift -= 8) {
+            frame.append(char((quint64(payload.size()) >> shift) & 0xFF));
+        }
+    }
+    frame.append(payload);
+    m_socket->write(frame);
+}
+
+ServerWorker::ServerWorker(ServerState* state)
+    : m_state(state)
+{
+}
+
+void ServerWorker::addConnection(qintptr socketDescriptor)
+{
+    new ServerConnection(socketDescriptor, m_state, this);
+}
+
+QuizServer::QuizServer(QuizManager* manager, QObject* parent)
+    : QTcpServer(parent)
+    , m_manager(manager)
+{
+    connect(m_manager, &QuizManager::sectionAdded, this, &QuizServer::refreshCatalog);
+    connect(m_manager, &QuizManager::sectionRemoved, this, &QuizServer::refreshCatalog);
+    connect(m_manager, &QuizManager::sectionEdited, this, &QuizServer::refreshCatalog);
+    connect(m_manager, &QuizManager::sectionReloaded, this, &QuizServer::refreshCatalog);
+    connect(&m_expiryTimer, &QTimer::timeout, this, &QuizServer::expireIdleSessions);
+
+    // QuizManager не потокобезопасен: загруженный банк передаётся ему в главный поток без ожидания,
+    // чтобы раздел учитывался в бюджете памяти и не читался повторно окном
+    m_state.setBankLoadedHandler([this](const QString& name, const ServerCatalog::Section& files,
+                                        const QSharedPointer<const QuestionBank>& bank) {
+        QMetaObject::invokeMethod(this, [this, name, files, bank]() {
+            m_manager->adoptSectionBank(name, files.questionsFile, files.answersFile, bank);
+        }, Qt::QueuedConnection);
+    });
+}
+
+QuizServer::~QuizServer()
+{
+    close();
+    for (QThread* thread : m_threads) {
+        thread->quit();
+        thread->wait();
+    }
+}
+
+bool QuizServer::start(const QHostAddress& address, quint16 port, int threads)
+{
+    refreshCatalog();
+
+    // Каждый поток-обработчик обслуживает свои соединения в собственном цикле событий
+    const int count = threads > 0 ? threads : QThread::idealThreadCount();
+    for (int i = 0; i < count; ++i) {
+        QThread* thread = new QThread(this);
+        ServerWorker* worker = new ServerWorker(&m_state);
+        worker->moveToThread(thread);
+        // finished испускается в самом потоке после выхода из цикла событий: обработчик вместе
+        // с соединениями удаляется там же и сразу, не полагаясь на отложенное удаление
+        connect(thread, &QThread::finished, thread, [worker]() { delete worker; }, Qt::DirectConnection);
+        thread->start();
+        m_threads.append(thread);
+        m_workers.append(worker);
+    }
+
+    if (!listen(address, port)) {
+        LOG_ERROR("Quiz server failed to listen on port " + QString::number(port) + ": " + errorString());
+        return false;
+    }
+    LOG_INFO("Quiz server listening on " + serverAddress().toString() + ":" + QString::number(serverPort())
+             + " with " + QString::number(count) + " worker threads");
+    return true;
+}
+
+void QuizServer::setSessionLimits(int maxSessions, int idleTimeoutSeconds)
+{
+    m_state.setMaxSessions(maxSessions);
+    m_idleTimeoutMs = qint64(qMax(0, idleTimeoutSeconds)) * 1000;
+
+    // Брошенные вкладки браузера не завершают сессию сами, поэтому пул периодически очищается
+    if (m_idleTimeoutMs > 0) {
+        m_expiryTimer.start(int(qBound<qint64>(1000, m_idleTimeoutMs / 4, 60 * 1000)));
+    } else {
+        m_expiryTimer.stop();
+    }
+}
+
+void QuizServer::expireIdleSessions()
+{
+    const int removed = m_state.expireIdleSessions(m_idleTimeoutMs);
+    if (removed > 0) {
+        LOG_INFO("Quiz server expired " + QString::number(removed) + " idle sessions");
+    }
+}
+
+void QuizServer::incomingConnection(qintptr socketDescriptor)
+{
+    ServerWorker* worker = m_workers[m_nextWorker];
+    m_nextWorker = (m_nextWorker + 1) % m_workers.size();
+    QMetaObject::invokeMethod(worker, [worker, socketDescriptor]() { worker->addConnection(socketDescriptor); },
+                              Qt::QueuedConnection);
+}
+
+void QuizServer::refreshCatalog()
+{
+    // Снимок хранит только имена и файлы разделов, поэтому обновление не загружает банки;
+    // уже начатые сессии продолжают работать со своими версиями банков
+    QSharedPointer<ServerCatalog> catalog(new ServerCatalog);
+    catalog->answerOptionCount = m_manager->answerOptionCount();
+    for (const QString& name : m_manager->getSectionNames()) {
+        catalog->sections.insert(name, { m_manager->getSectionQuestionsFile(name),
+                                         m_manager->getSectionAnswersFile(name) });
+    }
+    m_state.setCatalog(catalog);
+    LOG_INFO("Quiz server catalog updated: " + QString::number(catalog->sections.size()) + " sections");
+}
@@ -0,0 +1,183 @@
+#include "quizsession.h"
+#include "metrics.h"
+#include "optionsampler.h"
+#include "sessionrandom.h"
+#include <algorithm>
+
+QuizSession::QuizSession(Mode mode, const QVector<Part>& parts, quint64 seed, int optionCount)
+    : m_mode(mode)
+    , m_seed(seed)
+    , m_optionCount(optionCount)
+    , m_parts(parts)
+{
+    rebuildOffsets();
+    m_statuses.clear(totalQuestions());
+}
+
+QString QuizSession::questionText() const
+{
+    if (m_questionIndex >= sectionQuestionCount()) {
+        return QString();
+    }
+    return bank().text(m_questionIndex);
+}
+
+QString QuizSession::correctAnswer() const
+{
+    if (m_questionIndex >= sectionQuestionCount()) {
+        return QString();
+    }
+    return bank().correctAnswer(m_questionIndex);
+}
+
+QStringList QuizSession::answers() const
+{
+    METRICS_SCOPED_TIMER("quizown_answer_generation_seconds", "Generating answer options for a question");
+
+    QStringList result;
+    if (m_questionIndex >= sectionQuestionCount()) {
+        return result;
+    }
+
+    // Поток генератора зависит только от зерна сессии и вопроса, поэтому при
+    // перерисовке варианты и их порядок не меняются
+    const QuestionBank& questions = bank();
+    SessionRandom generator = SessionRandom::forQuestion(m_seed, sectionName(), m_questionIndex);
+
+    if (m_mode == Mode::Test) {
+        // Неправильные ответы - правильные ответы других вопросов раздела
+        const OptionSampler::Sample sample = OptionSampler::sample(
+            questions.size(), m_questionIndex, m_optionCount, generator);
+        result.reserve(sample.count);
+        for (int i = 0; i < sample.count; ++i) {
+            result.append(questions.correctAnswer(sample.indices[i]));
+        }
+        return result;
+    }
+
+    const int optionCount = questions.optionCount(m_questionIndex);
+    const OptionSampler::Permutation permutation = OptionSampler::permutation(optionCount, generator);
+    result.reserve(optionCount);
+    for (int i = 0; i < permutation.count; ++i) {
+        result.append(questions.option(m_questionIndex, permutation.order[i]));
+    }
+    for (int i = permutation.count; i < optionCount; ++i) {
+        result.append(questions.option(m_questionIndex, i));
+    }
+    return result;
+}
+
+bool QuizSession::checkAnswer(const QString& answer)
+{
+    METRICS_SCOPED_TIMER("quizown_answer_check_seconds", "Checking an answer");
+
+    if (m_questionIndex >= sectionQuestionCount()) {
+        return false;
+    }
+
+    const bool correct = bank().optionView(m_questionIndex, bank().correctOption(m_questionIndex)) == answer;
+    // Статус и счёт определяет первый ответ, поэтому счёт - просто число правильных статусов
+    const int index = globalIndex();
+    if (!m_statuses.isAnswered(index)) {
+        m_statuses.set(index, correct);
+    }
+    return correct;
+}
+
+AnswerStatuses::Counts QuizSession::partCounts(int part) const
+{
+    if (part < 0 || part >= m_parts.size()) {
+        return AnswerStatuses::Counts();
+    }
+    return m_statuses.counts(m_offsets[part], m_offsets[part + 1] - m_offsets[part]);
+}
+
+bool QuizSession::next()
+{
+    if (m_questionIndex + 1 < sectionQuestionCount()) {
+        ++m_questionIndex;
+        return true;
+    }
+
+    // Переходим к первому вопросу следующего непустого раздела
+    for (int part = m_currentPart + 1; part < m_parts.size(); ++part) {
+        if (m_parts[part].bank->size() > 0) {
+            m_currentPart = part;
+            m_questionIndex = 0;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool QuizSession::previous()
+{
+    if (m_questionIndex > 0) {
+        --m_questionIndex;
+        return true;
+    }
+
+    // Переходим к последнему вопросу предыдущего непустого раздела
+    for (int part = m_currentPart - 1; part >= 0; --part) {
+        if (m_parts[part].bank->size() > 0) {
+            m_currentPart = part;
+            m_questionIndex = m_parts[part].bank->size() - 1;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool QuizSession::goTo(int index)
+{
+    if (index < 0 || index >= totalQuestions()) {
+        return false;
+    }
+
+    // Ищем последний раздел, смещение которого не превышает index (пустые разделы пропускаются)
+    auto it = std::upper_bound(m_offsets.constBegin(), m_offsets.constEnd(), index);
+    m_currentPart = int(it - m_offsets.constBegin()) - 1;
+    m_questionIndex = index - m_offsets[m_currentPart];
+    return true;
+}
+
+void QuizSession::reset()
+{
+    m_currentPart = 0;
+    m_questionIndex = 0;
+    m_statuses.clear(totalQuestions());
+}
+
+void QuizSession::replacePart(int part, const Part& replacement)
+{
+    if (part < 0 || part >= m_parts.size() || !replacement.bank) {
+        return;
+    }
+
+    const QVector<int> oldOffsets = m_offsets;
+    const AnswerStatuses oldStatuses = m_statuses;
+    m_parts[part] = replacement;
+    rebuildOffsets();
+
+    // Переносим статусы уже отвеченных вопросов по разделам, чтобы индексы остались стабильными
+    m_statuses.clear(totalQuestions());
+    for (int i = 0; i < m_parts.size(); ++i) {
+        const int count = qMin(oldOffsets[i + 1] - oldOffsets[i], m_offsets[i + 1] - m_offsets[i]);
+        m_statuses.copyRange(oldStatuses, oldOffsets[i], m_offsets[i], count);
+    }
+
+    if (m_questionIndex >= sectionQuestionCount()) {
+        m_questionIndex = qMax(0, sectionQuestionCount() - 1);
+    }
+}
+
+void QuizSession::rebuildOffsets()
+{
+    // Таблица смещений разделов (префиксные суммы количества вопросов)
+    m_offsets.clear();
+    m_offsets.reserve(m_parts.size() + 1);
+    m_offsets.append(0);
+    for (const Part& part : m_parts) {
+        m_offsets.append(m_offsets.last() + part.bank->size());
+    }
+}
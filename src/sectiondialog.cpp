@@ -1,4 +1,5 @@
 #include "sectiondialog.h"
+#include "questionbank.h"
 #include <QFileDialog>
 #include <QMessageBox>
 
@@ -97,7 +98,7 @@ void SectionDialog::onBrowseQuestions()
     QString file = QFileDialog::getOpenFileName(this,
                                               tr("Выберите файл вопросов"),
                                               QString(),
-                                              tr("Текстовые файлы (*.txt);;Все файлы (*.*)"));
+                                              tr("Текстовые файлы (*.txt);;Скомпилированные банки (*.qzb);;Все файлы (*.*)"));
     if (!file.isEmpty()) {
         m_questionsFileEdit->setText(file);
     }
@@ -128,8 +129,9 @@ void SectionDialog::onAccepted()
         return;
     }
 
+    // Скомпилированный банк .qzb уже содержит варианты ответов
     QString answersFile = getAnswersFile();
-    if (answersFile.isEmpty()) {
+    if (answersFile.isEmpty() && !QuestionBank::isCompiledFile(questionsFile)) {
         QMessageBox::warning(this, tr("Ошибка"), tr("Выберите файл ответов"));
         return;
     }
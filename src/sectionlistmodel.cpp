@@ -0,0 +1,240 @@
+#include "sectionlistmodel.h"
+#include <algorithm>
+
+SectionListModel::SectionListModel(QuizManager *manager, QObject *parent)
+    : QAbstractListModel(parent)
+    , m_manager(manager)
+{
+    // Сортируются номера, а не строки: имена остаются в менеджере
+    m_order = m_manager->sectionIds();
+    std::sort(m_order.begin(), m_order.end(), [this](SectionId a, SectionId b) {
+        return nameOf(a) < nameOf(b);
+    });
+    m_rows = m_order;
+
+    if (!m_order.isEmpty()) {
+        m_checked.resize(*std::max_element(m_order.cbegin(), m_order.cend()) + 1);
+    }
+    for (SectionId id : std::as_const(m_order)) {
+        m_checked.setBit(id);
+    }
+
+    connect(m_manager, &QuizManager::sectionAdded, this, &SectionListModel::onSectionAdded);
+    connect(m_manager, &QuizManager::sectionRemoved, this, &SectionListModel::onSectionRemoved);
+    connect(m_manager, &QuizManager::sectionEdited, this, &SectionListModel::onSectionEdited);
+}
+
+int SectionListModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : int(m_rows.size());
+}
+
+QVariant SectionListModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_rows.size()) {
+        return QVariant();
+    }
+
+    // Вид запрашивает только видимые строки, поэтому данные не готовятся заранее
+    const SectionId id = m_rows[index.row()];
+    switch (role) {
+        case Qt::DisplayRole:
+            return nameOf(id);
+        case Qt::ToolTipRole: {
+            const QuizManager::Section &section = m_manager->section(id);
+            return section.questionsFile + '\n' + section.answersFile;
+        }
+        case Qt::CheckStateRole:
+            if (m_checkable) {
+                return isChecked(id) ? Qt::Checked : Qt::Unchecked;
+            }
+            return QVariant();
+        default:
+            return QVariant();
+    }
+}
+
+Qt::ItemFlags SectionListModel::flags(const QModelIndex &index) const
+{
+    Qt::ItemFlags result = QAbstractListModel::flags(index) | Qt::ItemNeverHasChildren;
+    if (m_checkable && index.isValid()) {
+        result |= Qt::ItemIsUserCheckable;
+    }
+    return result;
+}
+
+bool SectionListModel::setData(const QModelIndex &index, const QVariant &value, int role)
+{
+    if (!m_checkable || role != Qt::CheckStateRole || !index.isValid() || index.row() >= m_rows.size()) {
+        return false;
+    }
+    setChecked(m_rows[index.row()], value.toInt() == Qt::Checked);
+    emit dataChanged(index, index, { Qt::CheckStateRole });
+    return true;
+}
+
+QString SectionListModel::sectionName(int row) const
+{
+    return row >= 0 && row < m_rows.size() ? nameOf(m_rows[row]) : QString();
+}
+
+int SectionListModel::rowOf(const QString &name) const
+{
+    const SectionId id = m_manager->sectionId(name);
+    if (id == QuizManager::InvalidSection) {
+        return -1;
+    }
+    const int row = lowerBound(m_rows, name);
+    return row < m_rows.size() && m_rows[row] == id ? row : -1;
+}
+
+void SectionListModel::setFilter(const QString &text)
+{
+    const QString filter = text.trimmed();
+    if (filter == m_filter) {
+        return;
+    }
+
+    // Если новый фильтр содержит старый, подходящие разделы уже среди видимых строк,
+    // поэтому при наборе каждой следующей буквы просматривается всё меньше разделов
+    const bool refine = filter.contains(m_filter, Qt::CaseInsensitive);
+    m_filter = filter;
+
+    QVector<SectionId> rows;
+    if (m_filter.isEmpty()) {
+        rows = m_order;
+    } else {
+        const QVector<SectionId> &source = refine ? m_rows : m_order;
+        rows.reserve(source.size());
+        for (SectionId id : source) {
+            if (matches(id)) {
+                rows.append(id);
+            }
+        }
+    }
+
+    beginResetModel();
+    m_rows = std::move(rows);
+    endResetModel();
+}
+
+void SectionListModel::setCheckable(bool checkable)
+{
+    if (m_checkable == checkable) {
+        return;
+    }
+    beginResetModel();
+    m_checkable = checkable;
+    endResetModel();
+}
+
+void SectionListModel::setVisibleChecked(bool checked)
+{
+    if (m_rows.isEmpty()) {
+        return;
+    }
+    for (SectionId id : std::as_const(m_rows)) {
+        setChecked(id, checked);
+    }
+    emit dataChanged(index(0), index(int(m_rows.size()) - 1), { Qt::CheckStateRole });
+}
+
+QStringList SectionListModel::checkedSectionNames() const
+{
+    // Отмеченные разделы, скрытые фильтром, тоже попадают в выбор
+    QStringList names;
+    for (SectionId id : m_order) {
+        if (isChecked(id)) {
+            names.append(nameOf(id));
+        }
+    }
+    return names;
+}
+
+void SectionListModel::onSectionAdded(const QString &name)
+{
+    const SectionId id = m_manager->sectionId(name);
+    if (id != QuizManager::InvalidSection) {
+        insertSection(id, true);
+    }
+}
+
+void SectionListModel::onSectionRemoved(const QString &name, SectionId id)
+{
+    Q_UNUSED(name);
+    // Имя раздела в менеджере уже стёрто, поэтому строка ищется по номеру из сигнала
+    const int orderIndex = m_order.indexOf(id);
+    if (orderIndex >= 0) {
+        removeAt(orderIndex, id);
+    }
+}
+
+void SectionListModel::onSectionEdited(const QString &name)
+{
+    const SectionId id = m_manager->sectionId(name);
+    const int orderIndex = m_order.indexOf(id);
+    if (orderIndex < 0) {
+        return;
+    }
+
+    // Имя не сменило позицию и видимость: достаточно перерисовать строку
+    const int row = m_rows.indexOf(id);
+    const bool inPlace = (orderIndex == 0 || nameOf(m_order[orderIndex - 1]) < name)
+        && (orderIndex + 1 == m_order.size() || name < nameOf(m_order[orderIndex + 1]));
+    if (inPlace && (row >= 0) == matches(id)) {
+        if (row >= 0) {
+            emit dataChanged(index(row), index(row));
+        }
+        return;
+    }
+
+    const bool checked = isChecked(id);
+    removeAt(orderIndex, id);
+    insertSection(id, checked);
+}
+
+bool SectionListModel::matches(SectionId id) const
+{
+    return m_filter.isEmpty() || nameOf(id).contains(m_filter, Qt::CaseInsensitive);
+}
+
+int SectionListModel::lowerBound(const QVector<SectionId> &ids, const QString &name) const
+{
+    auto it = std::lower_bound(ids.cbegin(), ids.cend(), name, [this](SectionId id, const QString &value) {
+        return nameOf(id) < value;
+    });
+    return int(it - ids.cbegin());
+}
+
+void SectionListModel::insertSection(SectionId id, bool checked)
+{
+    const QString &name = nameOf(id);
+    m_order.insert(lowerBound(m_order, name), id);
+    setChecked(id, checked);
+
+    if (matches(id)) {
+        const int row = lowerBound(m_rows, name);
+        beginInsertRows(QModelIndex(), row, row);
+        m_rows.insert(row, id);
+        endInsertRows();
+    }
+}
+
+void SectionListModel::removeAt(int orderIndex, SectionId id)
+{
+    m_order.removeAt(orderIndex);
+    const int row = m_rows.indexOf(id);
+    if (row >= 0) {
+        beginRemoveRows(QModelIndex(), row, row);
+        m_rows.removeAt(row);
+        endRemoveRows();
+    }
+}
+
+void SectionListModel::setChecked(SectionId id, bool checked)
+{
+    if (id >= m_checked.size()) {
+        m_checked.resize(id + 1);
+    }
+    m_checked.setBit(id, checked);
+}
@@ -0,0 +1,93 @@
+#include "sessionpool.h"
+#include "sessionrandom.h"
+#include <QThread>
+
+SessionPool::SessionPool(int shardCount)
+    : m_nextId(1)
+{
+    // Число сегментов - степень двойки не меньше 4 * число ядер, номер сегмента берётся маской
+    const int wanted = shardCount > 0 ? shardCount : QThread::idealThreadCount() * 4;
+    int count = 1;
+    while (count < wanted) {
+        count *= 2;
+    }
+    m_shards.reset(new Shard[count]);
+    m_shardMask = SessionId(count - 1);
+    m_clock.start();
+}
+
+SessionPool::SessionId SessionPool::create(QuizSession::Mode mode, const QVector<QuizSession::Part>& parts,
+                                           quint64 seed, int optionCount)
+{
+    // Место в пуле занимается до создания сессии, чтобы предел не превышался при одновременных create
+    int current = m_size.loadRelaxed();
+    do {
+        if (m_maxSessions > 0 && current >= m_maxSessions) {
+            return InvalidSession;
+        }
+    } while (!m_size.testAndSetRelaxed(current, current + 1, current));
+
+    // Сессия создаётся вне блокировки; последовательные номера равномерно ложатся по сегментам
+    QSharedPointer<QuizSession> session(
+        new QuizSession(mode, parts, seed ? seed : SessionRandom::newSeed(), optionCount));
+    const SessionId id = m_nextId.fetchAndAddRelaxed(1);
+
+    Shard& shard = shardFor(id);
+    QMutexLocker locker(&shard.mutex);
+    shard.sessions.insert(id, { session, m_clock.elapsed() });
+    return id;
+}
+
+QSharedPointer<QuizSession> SessionPool::find(SessionId id) const
+{
+    Shard& shard = shardFor(id);
+    QMutexLocker locker(&shard.mutex);
+    auto it = shard.sessions.find(id);
+    if (it == shard.sessions.end()) {
+        return QSharedPointer<QuizSession>();
+    }
+    it->lastUsed = m_clock.elapsed();
+    return it->session;
+}
+
+bool SessionPool::remove(SessionId id)
+{
+    QSharedPointer<QuizSession> session;
+    {
+        Shard& shard = shardFor(id);
+        QMutexLocker locker(&shard.mutex);
+        session = shard.sessions.take(id).session;
+    }
+    if (session.isNull()) {
+        return false;
+    }
+    // Последняя ссылка на сессию (и, возможно, на банки) освобождается уже без блокировки
+    m_size.fetchAndSubRelaxed(1);
+    return true;
+}
+
+int SessionPool::removeIdle(qint64 maxIdleMs)
+{
+    const qint64 now = m_clock.elapsed();
+    int removed = 0;
+    QVector<QSharedPointer<QuizSession>> expired;
+    for (SessionId i = 0; i <= m_shardMask; ++i) {
+        {
+            // Сегменты просматриваются по одному, остальные в это время доступны
+            QMutexLocker locker(&m_shards[i].mutex);
+            QHash<SessionId, Entry>& sessions = m_shards[i].sessions;
+            for (auto it = sessions.begin(); it != sessions.end();) {
+                if (now - it->lastUsed > maxIdleMs) {
+                    expired.append(it->session);
+                    it = sessions.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+        }
+        removed += int(expired.size());
+        m_size.fetchAndSubRelaxed(int(expired.size()));
+        expired.clear();
+    }
+    return removed;
+}
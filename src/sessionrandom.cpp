@@ -0,0 +1,81 @@
+#include "sessionrandom.h"
+#include <QRandomGenerator>
+
+namespace {
+
+quint32 rotateLeft(quint32 value, int bits)
+{
+    return (value << bits) | (value >> (32 - bits));
+}
+
+// FNV-1a: стабильный между запусками хэш имени раздела (qHash зависит от случайной соли)
+quint64 stableHash(QStringView text)
+{
+    quint64 hash = 0xCBF29CE484222325ULL;
+    for (QChar c : text) {
+        hash ^= c.unicode();
+        hash *= 0x100000001B3ULL;
+    }
+    return hash;
+}
+
+} // namespace
+
+SessionRandom::SessionRandom(quint64 seed)
+{
+    quint64 state = seed;
+    const quint64 first = splitMix(state);
+    const quint64 second = splitMix(state);
+    m_state[0] = quint32(first);
+    m_state[1] = quint32(first >> 32);
+    m_state[2] = quint32(second);
+    m_state[3] = quint32(second >> 32);
+}
+
+SessionRandom SessionRandom::forQuestion(quint64 sessionSeed, QStringView section, int questionIndex)
+{
+    quint64 state = sessionSeed ^ stableHash(section);
+    state = splitMix(state) + quint64(quint32(questionIndex)) * 0x9E3779B97F4A7C15ULL;
+    return SessionRandom(state);
+}
+
+quint64 SessionRandom::newSeed()
+{
+    return QRandomGenerator::global()->generate64();
+}
+
+quint64 SessionRandom::splitMix(quint64& state)
+{
+    quint64 z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+quint32 SessionRandom::generate()
+{
+    const quint32 result = rotateLeft(m_state[1] * 5, 7) * 9;
+    const quint32 t = m_state[1] << 9;
+    m_state[2] ^= m_state[0];
+    m_state[3] ^= m_state[1];
+    m_state[1] ^= m_state[2];
+    m_state[0] ^= m_state[3];
+    m_state[2] ^= t;
+    m_state[3] = rotateLeft(m_state[3], 11);
+    return result;
+}
+
+quint32 SessionRandom::bounded(quint32 highest)
+{
+    // Метод Лемира: умножение вместо деления, редкий отброс ради равномерности
+    quint64 product = quint64(generate()) * highest;
+    quint32 low = quint32(product);
+    if (low < highest) {
+        const quint32 threshold = quint32(-highest) % highest;
+        while (low < threshold) {
+            product = quint64(generate()) * highest;
+            low = quint32(product);
+        }
+    }
+    return quint32(product >> 32);
+}
@@ -0,0 +1,250 @@
+#include "sheetgrader.h"
+#include "lineparser.h"
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QThread>
+#include <QThreadPool>
+#include <QtConcurrent>
+#include <numeric>
+
+namespace {
+
+// Разбирает одно поле CSV начиная с position; кавычки снимаются, "" заменяются на "
+QByteArray nextCsvField(QByteArrayView line, qsizetype& position, bool& ok)
+{
+    QByteArray field;
+    const qsizetype size = line.size();
+    if (position < size && line[position] == '"') {
+        ++position;
+        for (;;) {
+            if (position >= size) {
+                ok = false;
+                return field;
+            }
+            const char c = line[position++];
+            if (c != '"') {
+                field.append(c);
+            } else if (position < size && line[position] == '"') {
+                field.append('"');
+                ++position;
+            } else {
+                break;
+            }
+        }
+        if (position < size && line[position] != ',') {
+            ok = false;
+        }
+    } else {
+        const char* begin = line.data() + position;
+        const char* comma = LineScanner::findByte(begin, line.data() + size, ',');
+        field = QByteArray(begin, comma - begin).trimmed();
+        position += comma - begin;
+    }
+    ++position;
+    return field;
+}
+
+} // namespace
+
+SheetGrader::Format SheetGrader::formatForFile(const QString& filePath)
+{
+    const QString suffix = QFileInfo(filePath).suffix().toLower();
+    return suffix == "jsonl" || suffix == "ndjson" || suffix == "json" ? Format::JsonLines : Format::Csv;
+}
+
+int SheetGrader::addSection(const QString& name, const QSharedPointer<const QuestionBank>& bank)
+{
+    if (!bank || m_sectionIds.contains(name)) {
+        return -1;
+    }
+
+    // Правильные ответы заранее переводятся в UTF-8, чтобы сравнивать байты без декодирования строк
+    Section section;
+    section.name = name;
+    section.bank = bank;
+    section.correctUtf8.reserve(bank->size());
+    for (int i = 0; i < bank->size(); ++i) {
+        section.correctUtf8.append(bank->correctAnswer(i).toUtf8());
+    }
+    section.stats.resize(bank->size());
+
+    const int id = m_sections.size();
+    m_sections.append(section);
+    m_sectionIds.insert(name, id);
+    return id;
+}
+
+QVector<SheetGrader::Result> SheetGrader::grade(const QVector<QByteArray>& lines, Format format,
+                                                QVector<int>* rejected)
+{
+    // Пакет делится на несколько кусков на ядро, чтобы выровнять нагрузку
+    const int chunkCount = qMax(1, qMin(int(lines.size()), QThread::idealThreadCount() * 4));
+    QVector<Chunk> chunks;
+    chunks.reserve(chunkCount);
+    for (int i = 0; i < chunkCount; ++i) {
+        Chunk chunk;
+        chunk.begin = int(qint64(lines.size()) * i / chunkCount);
+        chunk.end = int(qint64(lines.size()) * (i + 1) / chunkCount);
+        chunks.append(chunk);
+    }
+
+    // Потоков-обработчиков не больше, чем потоков в пуле; каждый забирает следующий свободный кусок
+    // и копит статистику по вопросам в своих счётчиках без блокировок
+    const int workerCount = qMax(1, qMin(chunkCount, QThreadPool::globalInstance()->maxThreadCount()));
+    if (m_workerStats.size() < workerCount) {
+        m_workerStats.resize(workerCount);
+    }
+    QVector<int> workers(workerCount);
+    std::iota(workers.begin(), workers.end(), 0);
+
+    QVector<ChunkResult> chunkResults(chunkCount);
+    ChunkResult* chunkResultData = chunkResults.data();
+    WorkerStats* workerStats = m_workerStats.data();
+    QAtomicInt nextChunk(0);
+    QtConcurrent::blockingMap(workers, [&](int worker) {
+        for (int index = nextChunk.fetchAndAddRelaxed(1); index < chunkCount;
+             index = nextChunk.fetchAndAddRelaxed(1)) {
+            chunkResultData[index] = gradeChunk(lines, format, chunks.at(index), workerStats[worker]);
+        }
+    });
+
+    QVector<Result> results;
+    results.reserve(lines.size());
+    for (const ChunkResult& chunk : chunkResults) {
+        results.append(chunk.results);
+        if (rejected) {
+            rejected->append(chunk.rejected);
+        }
+    }
+    m_sheetsGraded += results.size();
+    return results;
+}
+
+const QVector<SheetGrader::QuestionStats>& SheetGrader::statistics(int section)
+{
+    // Счётчики потоков сливаются один раз по запросу, а не после каждого пакета
+    QVector<QuestionStats>& total = m_sections[section].stats;
+    for (WorkerStats& worker : m_workerStats) {
+        const QVector<QuestionStats> partial = worker.take(section);
+        for (int i = 0; i < partial.size(); ++i) {
+            total[i].attempts += partial[i].attempts;
+            total[i].correct += partial[i].correct;
+        }
+    }
+    return total;
+}
+
+SheetGrader::ChunkResult SheetGrader::gradeChunk(const QVector<QByteArray>& lines, Format format,
+                                                 const Chunk& chunk, WorkerStats& workerStats) const
+{
+    ChunkResult result;
+    result.results.reserve(chunk.end - chunk.begin);
+
+    QString candidate;
+    QString sectionName;
+    QVector<Answer> answers;
+    for (int i = chunk.begin; i < chunk.end; ++i) {
+        answers.clear();
+        const LineStatus status = format == Format::Csv
+            ? parseCsv(lines[i], candidate, sectionName, answers)
+            : parseJson(lines[i], candidate, sectionName, answers);
+        if (status == LineStatus::Header) {
+            continue;
+        }
+
+        const int id = m_sectionIds.value(sectionName, -1);
+        if (status == LineStatus::Rejected || id < 0 || answers.size() > m_sections[id].correctUtf8.size()) {
+            result.rejected.append(i);
+            continue;
+        }
+
+        const Section& section = m_sections[id];
+        QVector<QuestionStats>& stats = workerStats[id];
+        if (stats.isEmpty()) {
+            stats.resize(section.correctUtf8.size());
+        }
+
+        Result sheet;
+        sheet.candidate = candidate;
+        sheet.section = id;
+        for (int question = 0; question < answers.size(); ++question) {
+            const Answer& answer = answers[question];
+            if (!answer.isText && answer.option < 0) {
+                continue;
+            }
+            const bool correct = answer.isText
+                ? answer.text == section.correctUtf8[question]
+                : answer.option == section.bank->correctOption(question);
+            ++sheet.answered;
+            ++stats[question].attempts;
+            if (correct) {
+                ++sheet.correct;
+                ++stats[question].correct;
+            }
+        }
+        result.results.append(sheet);
+    }
+    return result;
+}
+
+SheetGrader::LineStatus SheetGrader::parseCsv(QByteArrayView line, QString& candidate, QString& section,
+                                              QVector<Answer>& answers)
+{
+    bool ok = true;
+    qsizetype position = 0;
+    candidate = QString::fromUtf8(nextCsvField(line, position, ok));
+    if (position > line.size()) {
+        return LineStatus::Rejected;
+    }
+    section = QString::fromUtf8(nextCsvField(line, position, ok));
+    if (!ok || candidate.isEmpty()) {
+        return LineStatus::Rejected;
+    }
+    if (candidate == QLatin1String("candidate") && section == QLatin1String("section")) {
+        return LineStatus::Header;
+    }
+
+    while (position <= line.size()) {
+        Answer answer;
+        answer.text = nextCsvField(line, position, ok);
+        answer.isText = !answer.text.isEmpty();
+        answers.append(answer);
+    }
+    return ok ? LineStatus::Parsed : LineStatus::Rejected;
+}
+
+SheetGrader::LineStatus SheetGrader::parseJson(QByteArrayView line, QString& candidate, QString& section,
+                                               QVector<Answer>& answers)
+{
+    QJsonParseError error;
+    const QJsonDocument document = QJsonDocument::fromJson(
+        QByteArray::fromRawData(line.data(), line.size()), &error);
+    if (error.error != QJsonParseError::NoError || !document.isObject()) {
+        return LineStatus::Rejected;
+    }
+
+    const QJsonObject object = document.object();
+    candidate = object["candidate"].toString();
+    section = object["section"].toString();
+    if (candidate.isEmpty() || !object["answers"].isArray()) {
+        return LineStatus::Rejected;
+    }
+
+    const QJsonArray values = object["answers"].toArray();
+    answers.reserve(values.size());
+    for (const QJsonValue& value : values) {
+        Answer answer;
+        if (value.isString()) {
+            answer.text = value.toString().toUtf8();
+            answer.isText = true;
+        } else if (value.isDouble()) {
+            answer.option = value.toInt(-1);
+        } else if (!value.isNull()) {
+            return LineStatus::Rejected;
+        }
+        answers.append(answer);
+    }
+    return LineStatus::Parsed;
+}
@@ -0,0 +1,105 @@
+#include "stringpool.h"
+#include <QHash>
+
+quint32 StringPool::hashOf(QStringView text)
+{
+    return quint32(qHash(text));
+}
+
+StringPool::Handle StringPool::intern(QStringView text)
+{
+    // Смещения и длины 32-битные, поэтому пул ограничен 4 Г символов
+    if (quint64(m_data.size()) + quint64(text.size()) > 0xFFFFFFFFull) {
+        return InvalidHandle;
+    }
+
+    if ((qsizetype(m_entries.size()) + 1) * 4 > qsizetype(m_slots.size()) * 3) {
+        rehash(qMax<qsizetype>(16, m_slots.size() * 2));
+    }
+
+    const quint32 hash = hashOf(text);
+    const qsizetype slot = findSlot(text, hash);
+    if (m_slots[slot] != InvalidHandle) {
+        return m_slots[slot];
+    }
+
+    const Handle handle = Handle(m_entries.size());
+    m_entries.append(Entry{ quint32(m_data.size()), quint32(text.size()), hash });
+    m_data.append(text);
+    m_slots[slot] = handle;
+    return handle;
+}
+
+QStringView StringPool::view(Handle handle) const
+{
+    if (handle >= Handle(m_entries.size())) {
+        return QStringView();
+    }
+    const Entry& entry = m_entries[handle];
+    return QStringView(m_data.constData() + entry.offset, qsizetype(entry.length));
+}
+
+qint64 StringPool::memoryUsage() const
+{
+    return qint64(m_data.capacity()) * qint64(sizeof(QChar))
+        + qint64(m_entries.capacity()) * qint64(sizeof(Entry))
+        + qint64(m_slots.capacity()) * qint64(sizeof(Handle));
+}
+
+void StringPool::reserve(qsizetype strings, qsizetype characters)
+{
+    m_data.reserve(characters);
+    m_entries.reserve(strings);
+
+    qsizetype slotCount = 16;
+    while (slotCount * 3 < strings * 4) {
+        slotCount *= 2;
+    }
+    if (slotCount > m_slots.size()) {
+        rehash(slotCount);
+    }
+}
+
+void StringPool::squeeze()
+{
+    m_data.squeeze();
+    m_entries.squeeze();
+}
+
+void StringPool::clear()
+{
+    m_data.clear();
+    m_entries.clear();
+    m_slots.clear();
+}
+
+qsizetype StringPool::findSlot(QStringView text, quint32 hash) const
+{
+    // Открытая адресация с линейным пробированием, размер таблицы - степень двойки
+    const qsizetype mask = m_slots.size() - 1;
+    qsizetype slot = qsizetype(hash) & mask;
+    for (;;) {
+        const Handle handle = m_slots[slot];
+        if (handle == InvalidHandle) {
+            return slot;
+        }
+        const Entry& entry = m_entries[handle];
+        if (entry.hash == hash && entry.length == quint32(text.size()) && view(handle) == text) {
+            return slot;
+        }
+        slot = (slot + 1) & mask;
+    }
+}
+
+void StringPool::rehash(qsizetype slotCount)
+{
+    m_slots.fill(InvalidHandle, slotCount);
+    const qsizetype mask = slotCount - 1;
+    for (qsizetype i = 0; i < m_entries.size(); ++i) {
+        qsizetype slot = qsizetype(m_entries[i].hash) & mask;
+        while (m_slots[slot] != InvalidHandle) {
+            slot = (slot + 1) & mask;
+        }
+        m_slots[slot] = Handle(i);
+    }
+}
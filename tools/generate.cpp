@@ -0,0 +1,274 @@
+#include "sessionrandom.h"
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QTextStream>
+#include <QtConcurrent>
+#include <algorithm>
+
+// Генератор синтетических банков вопросов для нагрузочных тестов, замеров памяти и запуска
+namespace {
+
+const char* const kCyrillicWords[] = {
+    "что", "как", "какой", "какая", "какие", "где", "когда", "почему", "объект", "класс", "указатель",
+    "ссылка", "память", "функция", "метод", "шаблон", "контейнер", "итератор", "поток", "исключение",
+    "конструктор", "деструктор", "наследование", "интерфейс", "переменная", "константа", "выражение",
+    "компилятор", "стандарт", "библиотека", "время", "жизни", "владение", "копирование", "перемещение",
+    "вызов", "аргумент", "значение", "тип", "массив", "строка", "сигнал", "слот", "событие", "окно",
+    "происходит", "возвращает", "гарантирует", "освобождает", "выделяет", "объявляет", "при", "для",
+    "после", "перед", "внутри", "без", "если", "только", "всегда", "никогда", "обычно", "неявно", "явно",
+    "статический", "виртуальный", "динамический", "безопасный", "уникальный", "общий", "слабый",
+    "std::vector", "std::move", "nullptr", "const", "QObject", "QString", "RAII", "noexcept",
+};
+
+const char* const kLatinWords[] = {
+    "what", "which", "how", "when", "why", "does", "the", "a", "an", "of", "in", "for", "with", "after",
+    "before", "object", "class", "pointer", "reference", "memory", "function", "method", "template",
+    "container", "iterator", "thread", "exception", "constructor", "destructor", "inheritance",
+    "interface", "variable", "constant", "expression", "compiler", "standard", "library", "lifetime",
+    "ownership", "copy", "move", "call", "argument", "value", "type", "array", "string", "signal", "slot",
+    "event", "returns", "guarantees", "releases", "allocates", "declares", "implicitly", "explicitly",
+    "static", "virtual", "dynamic", "safe", "unique", "shared", "weak", "always", "never", "only",
+    "std::unique_ptr", "std::shared_ptr", "constexpr", "override", "QThread", "QHash", "mutable",
+};
+
+struct Vocabulary {
+    QVector<QByteArray> words;
+    QVector<int> lengths;   // длина слова в символах, а не в байтах UTF-8
+};
+
+Vocabulary makeVocabulary(const char* const* words, int count)
+{
+    Vocabulary vocabulary;
+    for (int i = 0; i < count; ++i) {
+        vocabulary.words.append(QByteArray(words[i]));
+        vocabulary.lengths.append(int(QString::fromUtf8(words[i]).size()));
+    }
+    return vocabulary;
+}
+
+// Длина текста в символах: сумма равномерных величин (почти нормальное распределение)
+// с редким длинным хвостом. Только целочисленная арифметика, поэтому результат
+// при одном и том же зерне не зависит от платформы.
+int textLength(SessionRandom& random, int base, int terms, int spread, int tailChance, int tail)
+{
+    int length = base;
+    for (int i = 0; i < terms; ++i) {
+        length += int(random.bounded(quint32(spread)));
+    }
+    if (random.bounded(quint32(tailChance)) == 0) {
+        length += int(random.bounded(quint32(tail)));
+    }
+    return length;
+}
+
+void appendText(QByteArray& out, const Vocabulary& vocabulary, SessionRandom& random, int length, char ending)
+{
+    int written = 0;
+    bool first = true;
+    while (written < length) {
+        const int word = int(random.bounded(quint32(vocabulary.words.size())));
+        if (!first) {
+            out += ' ';
+            ++written;
+        }
+        const QByteArray& text = vocabulary.words[word];
+        // Первое латинское слово с заглавной буквы; кириллица и идентификаторы остаются как есть
+        if (first && text[0] >= 'a' && text[0] <= 'z' && !text.contains(':')) {
+            out += char(text[0] - 'a' + 'A');
+            out += text.mid(1);
+        } else {
+            out += text;
+        }
+        written += vocabulary.lengths[word];
+        first = false;
+    }
+    if (ending) {
+        out += ending;
+    }
+}
+
+struct SectionJob {
+    QString name;
+    QString questionsFile;
+    QString answersFile;
+    qint64 questionCount = 0;
+    qint64 bytes = 0;
+    bool ok = false;
+};
+
+struct Settings {
+    quint64 seed = 1;
+    int optionCount = 4;
+    int latinPercent = 30;
+    Vocabulary cyrillic;
+    Vocabulary latin;
+};
+
+// Пишет пару файлов раздела; поток случайных чисел зависит только от зерна и имени раздела,
+// поэтому разделы можно генерировать параллельно и в любом порядке
+void generateSection(const Settings& settings, SectionJob& job)
+{
+    QFile questions(job.questionsFile);
+    QFile answers(job.answersFile);
+    if (!questions.open(QIODevice::WriteOnly) || !answers.open(QIODevice::WriteOnly)) {
+        return;
+    }
+
+    SessionRandom random = SessionRandom::forQuestion(settings.seed, job.name, 0);
+    QByteArray questionBlock;
+    QByteArray answerBlock;
+    QVector<QByteArray> options(settings.optionCount);
+    for (qint64 i = 1; i <= job.questionCount; ++i) {
+        const Vocabulary& vocabulary =
+            int(random.bounded(100)) < settings.latinPercent ? settings.latin : settings.cyrillic;
+        const QByteArray number = QByteArray::number(i) + ". ";
+
+        questionBlock += number;
+        appendText(questionBlock, vocabulary, random, textLength(random, 20, 4, 30, 10, 160), '?');
+        questionBlock += '\n';
+
+        // Варианты внутри вопроса различны, иначе неправильный вариант совпал бы с правильным
+        const int correct = int(random.bounded(quint32(settings.optionCount)));
+        for (int option = 0; option < settings.optionCount; ++option) {
+            do {
+                options[option].clear();
+                appendText(options[option], vocabulary, random, textLength(random, 4, 3, 16, 12, 90), 0);
+            } while (std::find(options.cbegin(), options.cbegin() + option, options[option])
+                     != options.cbegin() + option);
+            answerBlock += number + options[option];
+            answerBlock += option == correct ? " {ans}\n" : "\n";
+        }
+        answerBlock += '\n';
+
+        if (answerBlock.size() >= (1 << 20) || i == job.questionCount) {
+            if (questions.write(questionBlock) != questionBlock.size()
+                || answers.write(answerBlock) != answerBlock.size()) {
+                return;
+            }
+            job.bytes += questionBlock.size() + answerBlock.size();
+            questionBlock.clear();
+            answerBlock.clear();
+        }
+    }
+    job.ok = true;
+}
+
+// "100K", "10M" и просто числа
+qint64 parseCount(const QString& text)
+{
+    QString digits = text.trimmed().toUpper();
+    qint64 multiplier = 1;
+    if (digits.endsWith('K')) {
+        multiplier = 1000;
+    } else if (digits.endsWith('M')) {
+        multiplier = 1000000;
+    }
+    if (multiplier > 1) {
+        digits.chop(1);
+    }
+    bool ok = false;
+    const qint64 value = digits.toLongLong(&ok);
+    return ok ? value * multiplier : -1;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("quizown-generate");
+    QCoreApplication::setApplicationVersion("1.0.0");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Generates synthetic QuizOwn question banks and a matching sections.json");
+    parser.addHelpOption();
+    parser.addVersionOption();
+    QCommandLineOption outputOption("output", "Output directory (default: generated)", "dir", "generated");
+    QCommandLineOption questionsOption("questions", "Total questions, e.g. 1000, 100K, 100M (default: 1K)", "count",
+                                       "1K");
+    QCommandLineOption sectionsOption("sections", "Number of sections to split questions into (default: 1)", "count",
+                                      "1");
+    QCommandLineOption optionsOption("options", "Answer options per question (default: 4)", "count", "4");
+    QCommandLineOption seedOption("seed", "Random seed; equal seeds give identical files (default: 1)", "seed", "1");
+    QCommandLineOption latinOption("latin", "Percent of questions in Latin script, the rest Cyrillic (default: 30)",
+                                   "percent", "30");
+    parser.addOptions({ outputOption, questionsOption, sectionsOption, optionsOption, seedOption, latinOption });
+    parser.process(app);
+
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    const qint64 totalQuestions = parseCount(parser.value(questionsOption));
+    const int sectionCount = parser.value(sectionsOption).toInt();
+    if (totalQuestions <= 0 || sectionCount <= 0 || sectionCount > totalQuestions) {
+        err << "Invalid --questions or --sections" << Qt::endl;
+        return 1;
+    }
+
+    Settings settings;
+    settings.seed = parser.value(seedOption).toULongLong();
+    settings.optionCount = qBound(2, parser.value(optionsOption).toInt(), 16);
+    settings.latinPercent = qBound(0, parser.value(latinOption).toInt(), 100);
+    settings.cyrillic = makeVocabulary(kCyrillicWords, int(sizeof(kCyrillicWords) / sizeof(kCyrillicWords[0])));
+    settings.latin = makeVocabulary(kLatinWords, int(sizeof(kLatinWords) / sizeof(kLatinWords[0])));
+
+    QDir outputDir(parser.value(outputOption));
+    if (!outputDir.mkpath(".")) {
+        err << "Failed to create output directory: " << outputDir.path() << Qt::endl;
+        return 1;
+    }
+
+    // Вопросы делятся между разделами поровну, остаток достаётся первым разделам
+    QVector<SectionJob> jobs(sectionCount);
+    const int nameWidth = QString::number(sectionCount).size();
+    for (int i = 0; i < sectionCount; ++i) {
+        SectionJob& job = jobs[i];
+        const QString number = QString("%1").arg(i + 1, nameWidth, 10, QChar('0'));
+        job.name = "Generated " + number;
+        job.questionsFile = outputDir.absoluteFilePath("section_" + number + "_questions.txt");
+        job.answersFile = outputDir.absoluteFilePath("section_" + number + "_answers.txt");
+        job.questionCount = totalQuestions / sectionCount + (i < totalQuestions % sectionCount ? 1 : 0);
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    QtConcurrent::blockingMap(jobs, [&settings](SectionJob& job) { generateSection(settings, job); });
+    const double seconds = double(timer.nsecsElapsed()) / 1e9;
+
+    QJsonObject catalog;
+    qint64 bytes = 0;
+    for (const SectionJob& job : jobs) {
+        if (!job.ok) {
+            err << "Failed to write section files: " << job.questionsFile << Qt::endl;
+            return 1;
+        }
+        QJsonObject section;
+        section["questionsFile"] = job.questionsFile;
+        section["answersFile"] = job.answersFile;
+        catalog[job.name] = section;
+        bytes += job.bytes;
+    }
+
+    QSaveFile catalogFile(outputDir.absoluteFilePath("sections.json"));
+    if (!catalogFile.open(QIODevice::WriteOnly)) {
+        err << "Failed to write " << catalogFile.fileName() << Qt::endl;
+        return 1;
+    }
+    catalogFile.write(QJsonDocument(catalog).toJson());
+    if (!catalogFile.commit()) {
+        err << "Failed to write " << catalogFile.fileName() << Qt::endl;
+        return 1;
+    }
+
+    out << "Generated " << totalQuestions << " questions in " << sectionCount << " sections, "
+        << bytes / (1024 * 1024) << " MB in " << seconds << " s ("
+        << (seconds > 0 ? double(totalQuestions) / seconds : 0.0) << " questions/s)" << Qt::endl;
+    out << "Catalog: " << catalogFile.fileName() << Qt::endl;
+    return 0;
+}
@@ -0,0 +1,203 @@
+#include "sheetgrader.h"
+#include "lineparser.h"
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QTextStream>
+#include <QtConcurrent>
+
+// Пакетная проверка бланков ответов после экзамена
+namespace {
+
+struct SectionEntry {
+    QString name;
+    QString questionsFile;
+    QString answersFile;
+    QSharedPointer<const QuestionBank> bank;
+};
+
+SectionEntry loadEntry(const SectionEntry& entry)
+{
+    SectionEntry loaded = entry;
+    loaded.bank = QuestionBank::load(entry.questionsFile, entry.answersFile);
+    return loaded;
+}
+
+QString csvField(const QString& value)
+{
+    if (!value.contains(',') && !value.contains('"')) {
+        return value;
+    }
+    QString escaped = value;
+    escaped.replace("\"", "\"\"");
+    return "\"" + escaped + "\"";
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("quizown-grade");
+    QCoreApplication::setApplicationVersion("1.0.0");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Grades QuizOwn answer sheets (CSV or JSONL) against section banks");
+    parser.addHelpOption();
+    parser.addVersionOption();
+    parser.addPositionalArgument("sheets", "Answer sheet files (.csv, .jsonl)", "<sheets...>");
+    QCommandLineOption sectionsOption("sections", "Sections catalog (default: sections.json)", "file", "sections.json");
+    QCommandLineOption scoresOption("scores", "Per-candidate scores output (default: scores.csv)", "file", "scores.csv");
+    QCommandLineOption statsOption("stats", "Per-question statistics output (default: question_stats.csv)", "file",
+                                   "question_stats.csv");
+    QCommandLineOption formatOption("format", "Sheet format: csv or jsonl (default: by file suffix)", "format");
+    QCommandLineOption batchOption("batch", "Sheets graded per parallel batch (default: 65536)", "count", "65536");
+    parser.addOptions({ sectionsOption, scoresOption, statsOption, formatOption, batchOption });
+    parser.process(app);
+
+    const QStringList sheetFiles = parser.positionalArguments();
+    if (sheetFiles.isEmpty()) {
+        parser.showHelp(1);
+    }
+
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+    const int batchSize = qMax(1, parser.value(batchOption).toInt());
+
+    // Банки разделов загружаются один раз и параллельно
+    QFile catalog(parser.value(sectionsOption));
+    if (!catalog.open(QIODevice::ReadOnly)) {
+        err << "Failed to open sections catalog: " << catalog.fileName() << Qt::endl;
+        return 1;
+    }
+    const QJsonObject catalogObject = QJsonDocument::fromJson(catalog.readAll()).object();
+    QVector<SectionEntry> entries;
+    for (auto it = catalogObject.constBegin(); it != catalogObject.constEnd(); ++it) {
+        SectionEntry entry;
+        entry.name = it.key();
+        entry.questionsFile = it.value().toObject()["questionsFile"].toString();
+        entry.answersFile = it.value().toObject()["answersFile"].toString();
+        entries.append(entry);
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    SheetGrader grader;
+    for (const SectionEntry& entry : QtConcurrent::blockingMapped<QVector<SectionEntry>>(entries, loadEntry)) {
+        if (!entry.bank || grader.addSection(entry.name, entry.bank) < 0) {
+            err << "Skipping section that failed to load: " << entry.name << Qt::endl;
+        }
+    }
+    out << "Loaded " << grader.sectionCount() << " sections in " << timer.elapsed() << " ms" << Qt::endl;
+
+    QSaveFile scoresFile(parser.value(scoresOption));
+    if (!scoresFile.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        err << "Failed to open scores output: " << scoresFile.fileName() << Qt::endl;
+        return 1;
+    }
+    QTextStream scores(&scoresFile);
+    scores << "candidate,section,correct,answered,total,percent\n";
+
+    qint64 rejectedCount = 0;
+    qint64 bytesRead = 0;
+    timer.restart();
+    for (const QString& sheetFile : sheetFiles) {
+        const SheetGrader::Format format = parser.isSet(formatOption)
+            ? (parser.value(formatOption) == "jsonl" ? SheetGrader::Format::JsonLines : SheetGrader::Format::Csv)
+            : SheetGrader::formatForFile(sheetFile);
+
+        QFile file(sheetFile);
+        if (!file.open(QIODevice::ReadOnly)) {
+            err << "Failed to open answer sheets: " << sheetFile << Qt::endl;
+            return 1;
+        }
+
+        // Бланки читаются потоково пакетами: пока один пакет проверяется, память не растёт с размером файла
+        LineReader reader(&file);
+        QByteArrayView line;
+        QVector<QByteArray> batch;
+        QVector<qint64> batchLines;
+        batch.reserve(batchSize);
+        batchLines.reserve(batchSize);
+        bool atEnd = false;
+        while (!atEnd) {
+            atEnd = !reader.next(line);
+            if (!atEnd) {
+                batch.append(line.toByteArray());
+                batchLines.append(reader.lineNumber());
+                if (batch.size() < batchSize) {
+                    continue;
+                }
+            }
+            if (batch.isEmpty()) {
+                break;
+            }
+
+            QVector<int> rejected;
+            const QVector<SheetGrader::Result> results = grader.grade(batch, format, &rejected);
+            for (const SheetGrader::Result& result : results) {
+                const int total = grader.bank(result.section).size();
+                scores << csvField(result.candidate) << ',' << csvField(grader.sectionName(result.section)) << ','
+                       << result.correct << ',' << result.answered << ',' << total << ','
+                       << QString::number(total > 0 ? 100.0 * result.correct / total : 0.0, 'f', 1) << '\n';
+            }
+            for (int index : rejected) {
+                if (rejectedCount++ < 20) {
+                    err << "Rejected record at line " << batchLines[index] << " in " << sheetFile << Qt::endl;
+                }
+            }
+            batch.clear();
+            batchLines.clear();
+        }
+        bytesRead += reader.bytesRead();
+        if (reader.hasError()) {
+            err << "Failed to read answer sheets: " << sheetFile << ": " << file.errorString() << Qt::endl;
+            return 1;
+        }
+        if (reader.hasInvalidUtf8()) {
+            err << "Answer sheets are not valid UTF-8: " << sheetFile << Qt::endl;
+        }
+    }
+    scores.flush();
+    const qint64 elapsed = timer.nsecsElapsed();
+
+    if (!scoresFile.commit()) {
+        err << "Failed to write scores: " << scoresFile.fileName() << Qt::endl;
+        return 1;
+    }
+
+    QSaveFile statsFile(parser.value(statsOption));
+    if (!statsFile.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        err << "Failed to open statistics output: " << statsFile.fileName() << Qt::endl;
+        return 1;
+    }
+    QTextStream stats(&statsFile);
+    stats << "section,question,attempts,correct,correct_rate\n";
+    for (int section = 0; section < grader.sectionCount(); ++section) {
+        const QVector<SheetGrader::QuestionStats>& questionStats = grader.statistics(section);
+        for (int question = 0; question < questionStats.size(); ++question) {
+            const SheetGrader::QuestionStats& entry = questionStats[question];
+            if (entry.attempts == 0) {
+                continue;
+            }
+            stats << csvField(grader.sectionName(section)) << ',' << question + 1 << ','
+                  << entry.attempts << ',' << entry.correct << ','
+                  << QString::number(double(entry.correct) / double(entry.attempts), 'f', 4) << '\n';
+        }
+    }
+    stats.flush();
+    if (!statsFile.commit()) {
+        err << "Failed to write statistics: " << statsFile.fileName() << Qt::endl;
+        return 1;
+    }
+
+    const double seconds = qMax(1e-9, double(elapsed) / 1e9);
+    out << "Graded " << grader.sheetsGraded() << " sheets (" << rejectedCount << " rejected, "
+        << bytesRead / 1024 << " KiB) in " << QString::number(seconds, 'f', 3) << " s: "
+        << QString::number(double(grader.sheetsGraded()) / seconds, 'f', 0) << " sheets/s" << Qt::endl;
+    return rejectedCount > 0 ? 2 : 0;
+}
@@ -0,0 +1,42 @@
+#include "questionbank.h"
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QTextStream>
+
+// Конвертер пары текстовых файлов вопросов и ответов в банк .qzb
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("quizown-compile");
+    QCoreApplication::setApplicationVersion("1.0.0");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Compiles a QuizOwn questions/answers text pair into a memory-mappable .qzb bank");
+    parser.addHelpOption();
+    parser.addVersionOption();
+    parser.addPositionalArgument("questions", "Questions text file");
+    parser.addPositionalArgument("answers", "Answers text file");
+    parser.addPositionalArgument("output", "Output .qzb file");
+    parser.process(app);
+
+    const QStringList args = parser.positionalArguments();
+    if (args.size() != 3) {
+        parser.showHelp(1);
+    }
+
+    QTextStream err(stderr);
+    if (!QuestionBank::compile(args.at(0), args.at(1), args.at(2))) {
+        err << "Failed to compile " << args.at(0) << " and " << args.at(1) << Qt::endl;
+        return 1;
+    }
+
+    // Проверяем, что результат открывается и совпадает по количеству вопросов
+    QSharedPointer<const QuestionBank> bank = QuestionBank::fromCompiledFile(args.at(2));
+    if (!bank) {
+        err << "Compiled bank could not be mapped: " << args.at(2) << Qt::endl;
+        return 1;
+    }
+
+    QTextStream(stdout) << "Compiled " << bank->size() << " questions to " << args.at(2) << Qt::endl;
+    return 0;
+}